@@ -0,0 +1,396 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "Accumulation.h"
+#include "Compression.h"
+#include "DynArray.h"
+#include "Indirect.h"
+#include "Serialization.h"
+
+namespace Bench{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Containers (n x m array of doubles): vla::dynarray<double, 2>.
+    //!                                             std::vector<double> (flat, row-major).
+    //!                                             std::vector<std::vector<double>>.
+    //!                                             new double[] (flat, row-major).
+    //!
+    struct DynArray{
+        using type = vla::dynarray<double, 2U>;
+        static type make(size_t n, size_t m){
+            return type(n, m);
+        }
+        static double& at(type& a, size_t i, size_t j){
+            return a(i, j);
+        }
+        static void fill(type& a, double value){
+            a.fill(value);
+        }
+    };
+    struct Vector{
+        struct type{
+            std::vector<double> data;
+            size_t              m;
+        };
+        static type make(size_t n, size_t m){
+            return type{std::vector<double>(n*m), m};
+        }
+        static double& at(type& a, size_t i, size_t j){
+            return a.data[i*a.m+j];
+        }
+        static void fill(type& a, double value){
+            std::fill(a.data.begin(), a.data.end(), value);
+        }
+    };
+    struct VectorVector{
+        using type = std::vector<std::vector<double>>;
+        static type make(size_t n, size_t m){
+            return type(n, std::vector<double>(m));
+        }
+        static double& at(type& a, size_t i, size_t j){
+            return a[i][j];
+        }
+        static void fill(type& a, double value){
+            for(auto& row : a){
+                std::fill(row.begin(), row.end(), value);
+            }
+        }
+    };
+    struct Raw{
+        struct type{
+            std::unique_ptr<double[]> data;
+            size_t                    n, m;
+            type(size_t n_, size_t m_) : data(new double[n_*m_]()), n(n_), m(m_){
+            }
+            type(const type& other) : type(other.n, other.m){
+                std::copy(other.data.get(), other.data.get()+n*m, data.get());
+            }
+            type(type&&) noexcept = default;
+            type& operator=(type&&) noexcept = default;
+        };
+        static type make(size_t n, size_t m){
+            return type(n, m);
+        }
+        static double& at(type& a, size_t i, size_t j){
+            return a.data[i*a.m+j];
+        }
+        static void fill(type& a, double value){
+            std::fill(a.data.get(), a.data.get()+a.n*a.m, value);
+        }
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Report throughput (elements/s and bytes/s) of n elements per iteration.
+    //!
+    void report(benchmark::State& state, size_t n){
+        state.SetItemsProcessed(state.iterations()*static_cast<int64_t>(n));
+        state.SetBytesProcessed(state.iterations()*static_cast<int64_t>(n*sizeof(double)));
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Shapes (n x m): thin, square and wide.
+    //!
+    void shapes(benchmark::internal::Benchmark* b){
+        for(int64_t n : {1 << 8, 1 << 11}){
+            b->Args({n, 3});
+            b->Args({n, n});
+            b->Args({3, n*n});
+        }
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Construction/destruction (n x m; vla::dynarray also as rank 1 (n*m) and rank 3 (n x m x 1)).
+    //!
+    template<typename C>
+    void construct(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        for(auto _ : state){
+            auto a = C::make(n, m);
+            benchmark::DoNotOptimize(&C::at(a, 0U, 0U));
+            benchmark::ClobberMemory();
+        }
+        report(state, n*m);
+    }
+    template<size_t N>
+    void construct_rank(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        for(auto _ : state){
+            if constexpr(N == 1U){
+                vla::dynarray<double, 1U> a(n*m);
+                benchmark::DoNotOptimize(a.data());
+            }
+            else{
+                vla::dynarray<double, 3U> a(n, m, 1U);
+                benchmark::DoNotOptimize(a.data());
+            }
+            benchmark::ClobberMemory();
+        }
+        report(state, n*m);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Sequential (innermost index fastest) and strided (outermost index fastest) element access.
+    //!
+    template<typename C>
+    void sequential(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto a = C::make(n, m);
+        for(auto _ : state){
+            double s = 0.0;
+            for(size_t i = 0U; i < n; ++i){
+                for(size_t j = 0U; j < m; ++j){
+                    s += C::at(a, i, j);
+                }
+            }
+            benchmark::DoNotOptimize(s);
+        }
+        report(state, n*m);
+    }
+    template<typename C>
+    void strided(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto a = C::make(n, m);
+        for(auto _ : state){
+            double s = 0.0;
+            for(size_t j = 0U; j < m; ++j){
+                for(size_t i = 0U; i < n; ++i){
+                    s += C::at(a, i, j);
+                }
+            }
+            benchmark::DoNotOptimize(s);
+        }
+        report(state, n*m);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Fill, copy and move.
+    //!
+    template<typename C>
+    void fill(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto a = C::make(n, m);
+        for(auto _ : state){
+            C::fill(a, 1.0);
+            benchmark::ClobberMemory();
+        }
+        report(state, n*m);
+    }
+    template<typename C>
+    void copy(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto a = C::make(n, m);
+        for(auto _ : state){
+            auto b(a);
+            benchmark::DoNotOptimize(&C::at(b, 0U, 0U));
+            benchmark::ClobberMemory();
+        }
+        report(state, n*m);
+    }
+    template<typename C>
+    void move(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto a = C::make(n, m);
+        for(auto _ : state){
+            auto b(std::move(a));
+            a = C::make(0U, 0U);
+            a = std::move(b);
+            benchmark::ClobberMemory();
+        }
+        report(state, n*m);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Comparison and I/O (1-D): operator== , operator<< (against std::vector<double> and new double[], see
+    //!        Raw) and binary save/load (see Serialization.h and Compression.h).
+    //!
+    template<typename C>
+    C ones(size_t n){
+        if constexpr(std::is_same_v<C, Raw::type>){
+            C a(n, 1U);
+            Raw::fill(a, 1.0);
+            return a;
+        }
+        else{
+            return C(n, 1.0);
+        }
+    }
+    template<typename C>
+    void compare(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const C a = ones<C>(n), b(a);
+        for(auto _ : state){
+            if constexpr(std::is_same_v<C, Raw::type>){
+                benchmark::DoNotOptimize(std::equal(a.data.get(), a.data.get()+n, b.data.get()));
+            }
+            else{
+                benchmark::DoNotOptimize(a == b);
+            }
+        }
+        report(state, n);
+    }
+    template<typename C>
+    void print(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const C a = ones<C>(n);
+        for(auto _ : state){
+            std::ostringstream o;
+            if constexpr(std::is_same_v<C, Raw::type>){
+                for(size_t i = 0U; i < n; ++i){
+                    o << a.data[i] << " ";
+                }
+            }
+            else if constexpr(std::is_same_v<C, std::vector<double>>){
+                for(auto x : a){
+                    o << x << " ";
+                }
+            }
+            else{
+                o << a;
+            }
+            benchmark::DoNotOptimize(o.str().size());
+        }
+        report(state, n);
+    }
+    void save_load(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto p = std::filesystem::temp_directory_path()/"DynArrayBench.bin";
+        vla::dynarray<double> a(n, 1.0), b(n);
+        for(auto _ : state){
+            vla::save(p, a);
+            vla::load(p, b);
+            benchmark::DoNotOptimize(b.data());
+        }
+        std::filesystem::remove(p);
+        report(state, 2U*n);
+    }
+    void save_load_compressed(benchmark::State& state){
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto p = std::filesystem::temp_directory_path()/"DynArrayBench.dcz";
+        vla::dynarray<double> a(n), b(n);
+        for(size_t i = 0U; i < n; ++i){
+            a[i] = 1.0+1e-3*static_cast<double>(i%1000U);
+        }
+        for(auto _ : state){
+            vla::save_compressed(p, a);
+            vla::load_compressed(p, b);
+            benchmark::DoNotOptimize(b.data());
+        }
+        const auto bytes = static_cast<double>(std::filesystem::file_size(p));
+        state.counters["ratio"] = static_cast<double>(n*sizeof(double))/bytes;
+        std::filesystem::remove(p);
+        report(state, 2U*n);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Concurrent scatter-add (see Accumulation.h): 2^20 contributions into n entries (pseudo-random), w/ an
+    //!        atomic view or privatised copies (merge incl.). Small n: high contention, large n: costly merge.
+    //!
+    template<bool Atomic>
+    void scatter(benchmark::State& state){
+        const auto   n = static_cast<size_t>(state.range(0));
+        const size_t m = 1U << 20U;
+        vla::dynarray<double> a(n);
+        const auto u = vla::parallel::make_atomic_view(a);
+        vla::parallel::privatized<double> w(a);
+        for(auto _ : state){
+            vla::parallel::for_range(m, [&](size_t first, size_t last){
+                if constexpr(Atomic){
+                    for(size_t e = first; e < last; ++e){
+                        u((e*2654435761U)%n) += 1.0;
+                    }
+                }
+                else{
+                    auto& b = w.local();
+                    for(size_t e = first; e < last; ++e){
+                        b[(e*2654435761U)%n] += 1.0;
+                    }
+                }
+            }, {.grain = 4096U});
+            if constexpr(!Atomic){
+                w.merge();
+            }
+            benchmark::ClobberMemory();
+        }
+        report(state, m);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Indirect read (see Indirect.h): 2^20 pseudo-random indices into n entries, element-wise (operator[])
+    //!        or batched (vla::gather: prefetching and hardware gathers).
+    //!
+    template<bool Batched>
+    void indirect(benchmark::State& state){
+        const auto   n = static_cast<size_t>(state.range(0));
+        const size_t m = 1U << 20U;
+        vla::dynarray<double> a(n, 1.0), b(m);
+        vla::dynarray<size_t> k(m);
+        for(size_t i = 0U; i < m; ++i){
+            k[i] = (i*2654435761U)%n;
+        }
+        for(auto _ : state){
+            if constexpr(Batched){
+                vla::gather(a, k, b);
+            }
+            else{
+                for(size_t i = 0U; i < m; ++i){
+                    b[i] = a[k[i]];
+                }
+            }
+            benchmark::ClobberMemory();
+        }
+        report(state, m);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    BENCHMARK(construct<DynArray>)->Apply(shapes);
+    BENCHMARK(construct<Vector>)->Apply(shapes);
+    BENCHMARK(construct<VectorVector>)->Apply(shapes);
+    BENCHMARK(construct<Raw>)->Apply(shapes);
+    BENCHMARK(construct_rank<1U>)->Apply(shapes);
+    BENCHMARK(construct_rank<3U>)->Apply(shapes);
+    BENCHMARK(sequential<DynArray>)->Apply(shapes);
+    BENCHMARK(sequential<Vector>)->Apply(shapes);
+    BENCHMARK(sequential<VectorVector>)->Apply(shapes);
+    BENCHMARK(sequential<Raw>)->Apply(shapes);
+    BENCHMARK(strided<DynArray>)->Apply(shapes);
+    BENCHMARK(strided<Vector>)->Apply(shapes);
+    BENCHMARK(strided<VectorVector>)->Apply(shapes);
+    BENCHMARK(strided<Raw>)->Apply(shapes);
+    BENCHMARK(fill<DynArray>)->Apply(shapes);
+    BENCHMARK(fill<Vector>)->Apply(shapes);
+    BENCHMARK(fill<VectorVector>)->Apply(shapes);
+    BENCHMARK(fill<Raw>)->Apply(shapes);
+    BENCHMARK(copy<DynArray>)->Apply(shapes);
+    BENCHMARK(copy<Vector>)->Apply(shapes);
+    BENCHMARK(copy<VectorVector>)->Apply(shapes);
+    BENCHMARK(copy<Raw>)->Apply(shapes);
+    BENCHMARK(move<DynArray>)->Apply(shapes);
+    BENCHMARK(move<Vector>)->Apply(shapes);
+    BENCHMARK(move<VectorVector>)->Apply(shapes);
+    BENCHMARK(move<Raw>)->Apply(shapes);
+    BENCHMARK(compare<vla::dynarray<double>>)->Range(1 << 8, 1 << 20);
+    BENCHMARK(compare<std::vector<double>>)->Range(1 << 8, 1 << 20);
+    BENCHMARK(compare<Raw::type>)->Range(1 << 8, 1 << 20);
+    BENCHMARK(print<vla::dynarray<double>>)->Range(1 << 8, 1 << 16);
+    BENCHMARK(print<std::vector<double>>)->Range(1 << 8, 1 << 16);
+    BENCHMARK(print<Raw::type>)->Range(1 << 8, 1 << 16);
+    BENCHMARK(save_load)->Range(1 << 8, 1 << 20);
+    BENCHMARK(save_load_compressed)->Range(1 << 8, 1 << 20)->UseRealTime();
+    BENCHMARK(scatter<true>)->Range(1 << 4, 1 << 20)->UseRealTime();
+    BENCHMARK(scatter<false>)->Range(1 << 4, 1 << 20)->UseRealTime();
+    BENCHMARK(indirect<false>)->Range(1 << 10, 1 << 24);
+    BENCHMARK(indirect<true>)->Range(1 << 10, 1 << 24);
+    //------------------------------------------------------------------------------------------------------------------
+}
+BENCHMARK_MAIN();
@@ -1,6 +1,29 @@
 set(headers
+    include/Accumulation.h
+    include/Allocator.h
+    include/Arena.h
+    include/Auxiliary.h
+    include/Compression.h
     include/DynArray.h
+    include/DynArrayView.h
+    include/Expression.h
+    include/Extents.h
+    include/Indirect.h
+    include/Instrumentation.h
+    include/Layout.h
+    include/MdArray.h
+    include/Numa.h
+    include/Numeric.h
+    include/Parallel.h
+    include/RaggedDynArray.h
+    include/Serialization.h
+    include/SmallDynArray.h
+    include/SoaDynArray.h
+    include/Stencil.h
 )
 set(test_sources
     test.cpp
+)
+set(benchmark_sources
+    bench.cpp
 )
\ No newline at end of file
@@ -0,0 +1,275 @@
+/**
+ * @file    Accumulation.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Concurrent scatter accumulation (atomic views and privatised buffers) for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_ACCUMULATION_H
+#define DYNARRAY_ACCUMULATION_H
+
+#include<algorithm>
+#include<atomic>
+#include<functional>
+#include<tuple>
+#include<type_traits>
+#include<vector>
+
+#include "Auxiliary.h"
+#include "DynArray.h"
+#include "DynArrayView.h"
+#include "Parallel.h"
+
+namespace vla::parallel{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Atomic reference to an element (relaxed ordering).
+    //! @note  Example: r.add(x) : r += x.
+    //!                 r.min(x) : r = min(r, x).
+    //!                 r.max(x) : r = max(r, x).
+    //!        Updates are atomic w.r.t. each other, not ordered w.r.t. other memory operations (the end of the
+    //!        parallel loop synchronises). add is a single fetch_add for integer and floating-point types (C++20), a
+    //!        compare-and-swap loop otherwise (as min/max).
+    //!
+    template<typename T>
+    class atomic_reference{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        std::atomic_ref<T> ref_;
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        explicit atomic_reference(T& x) noexcept : ref_(x){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: load/store.
+        //!                    add/min/max.
+        //!
+        T load() const noexcept{
+            return ref_.load(std::memory_order_relaxed);
+        }
+        void store(const T& value) const noexcept{
+            ref_.store(value, std::memory_order_relaxed);
+        }
+        void add(const T& value) const noexcept{
+            if constexpr(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>){
+                ref_.fetch_add(value, std::memory_order_relaxed);
+            }
+            else{
+                update([&value](const T& x){return x+value;});
+            }
+        }
+        void min(const T& value) const noexcept{
+            T x = load();
+            while(value < x && !ref_.compare_exchange_weak(x, value, std::memory_order_relaxed)){
+            }
+        }
+        void max(const T& value) const noexcept{
+            T x = load();
+            while(x < value && !ref_.compare_exchange_weak(x, value, std::memory_order_relaxed)){
+            }
+        }
+        const atomic_reference& operator+=(const T& value) const noexcept{
+            add(value);
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        template<typename F>
+        void update(F f) const noexcept{
+            T x = load();
+            while(!ref_.compare_exchange_weak(x, f(x), std::memory_order_relaxed)){
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Atomic (accumulation) view of an N-D array (view).
+    //! @note  Example: auto acc = vla::parallel::make_atomic_view(a);
+    //!                 vla::parallel::for_range(n_elements, [&](size_t first, size_t last){
+    //!                     for(size_t e = first; e < last; ++e){
+    //!                         acc(node(e, 0U)) += contribution(e, 0U); ...
+    //!                     }
+    //!                 });
+    //!        No extra memory; each update costs an atomic read-modify-write, and entries hit by several threads at
+    //!        once bounce between their caches. Prefer privatized (below) if updates are dense and highly contended.
+    //!
+    template<typename T, size_t N = 1U>
+    class atomic_view{
+        static_assert(alignof(T) >= std::atomic_ref<T>::required_alignment);
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        dynarray_view<T, N> view_;
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        explicit atomic_view(const dynarray_view<T, N>& view) noexcept : view_(view){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: operator() (atomic reference).
+        //!                        at         (idem, w/ bounds checking).
+        //!
+        template<typename ... Idx>
+        atomic_reference<T> operator()(Idx ... i) const noexcept{
+            return atomic_reference<T>(view_(i...));
+        }
+        template<typename ... Idx>
+        atomic_reference<T> at(Idx ... i) const{
+            return atomic_reference<T>(view_.at(i...));
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: size.
+        //!                  extents.
+        //!                  view (non-atomic, e.g. once the parallel loop has completed).
+        //!
+        size_t size() const noexcept{
+            return view_.size();
+        }
+        auto extents() const noexcept{
+            return view_.extents();
+        }
+        const dynarray_view<T, N>& view() const noexcept{
+            return view_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    template<typename X>
+    auto make_atomic_view(X& x) noexcept{
+        const auto v = vla::detail::view_of(x);
+        using T = std::remove_pointer_t<decltype(v.data())>;
+        return atomic_view<T, std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>>>(v);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Privatised accumulation buffer: one private copy of the target per thread, merged into it on demand.
+    //! @note  Example: vla::parallel::privatized<double, 2> acc(a);
+    //!                 vla::parallel::for_range(n_elements, [&](size_t first, size_t last){
+    //!                     auto& b = acc.local();                    : calling thread's copy.
+    //!                     for(size_t e = first; e < last; ++e){
+    //!                         b(i(e), j(e)) += contribution(e); ...
+    //!                     }
+    //!                 });
+    //!                 acc.merge();                                  : a += sum of the copies (in parallel).
+    //!        Copies are allocated (and first touched) by their thread on its first call to local(), filled w/ the
+    //!        identity init (e.g. +infinity to merge w/ vla::parallel::min_op). merge() combines target = op(target,
+    //!        copy) for each copy, chunk-wise in parallel along the outermost dimension, and resets the copies to init
+    //!        (allocations are kept for the next assembly). Updates are plain stores, at the cost of one copy per
+    //!        thread and an O(threads x size) merge. local() indexes copies by pool worker (see thread_pool::worker),
+    //!        hence threads outside the pool share the last copy and must not call local() concurrently.
+    //!
+    template<typename T, size_t N = 1U, template<typename U> typename A = std::allocator>
+    class privatized{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        dynarray_view<T, N>            target_; //!<Merged into.
+        T                              init_;   //!<Identity of the merge operation.
+        policy                         policy_;
+        std::vector<dynarray<T, N, A>> copies_; //!<Private copies (per pool worker, plus non-workers).
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        explicit privatized(const dynarray_view<T, N>& target, const T& init = T{}, const policy& p = {}) :
+            target_(target),
+            init_  (init),
+            policy_(p),
+            copies_(detail::pool(p).size()+1U){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: local (calling thread's copy, allocated on first use).
+        //!
+        dynarray<T, N, A>& local(){
+            auto& copy = copies_[detail::pool(policy_).worker()];
+            if(copy.empty() && target_.size() != 0U){
+                copy = std::apply([this](auto ... n){
+                    return dynarray<T, N, A>(n ..., init_);
+                }, target_.extents());
+            }
+            return copy;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: copies (number of allocated copies).
+        //!
+        size_t copies() const noexcept{
+            return static_cast<size_t>(std::count_if(copies_.begin(), copies_.end(), [](const auto& c){
+                return !c.empty();
+            }));
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: merge (target = op(target, copy) for each allocated copy, then copy = init).
+        //! @note  Copies are combined in worker order, not in the order contributions were made, hence non-associative
+        //!        (e.g. floating-point) results depend on which thread ran which iterations.
+        //!
+        template<typename R = std::plus<>>
+        void merge(R op = {}){
+            if(target_.empty() || copies() == 0U){
+                return;
+            }
+            const size_t g = detail::grain(policy_, target_);
+            detail::pool(policy_).for_range(target_.extent(0U), g, [&, this](size_t first, size_t last){
+                const auto w = target_.slice(0U, first, last-first);
+                for(auto& c : copies_){
+                    if(c.empty()){
+                        continue;
+                    }
+                    vla::detail::for_each_row([&, this](size_t n, auto r, auto s){
+                        for(size_t j = 0U; j < n; ++j){
+                            r[j] = op(r[j], s[j]);
+                            s[j] = init_;
+                        }
+                    }, w, c.view().slice(0U, first, last-first));
+                }
+            }, policy_.pinned);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Merge operations (for privatized::merge): min_op.
+    //!                                                  max_op.
+    //!
+    struct min_op{
+        template<typename T>
+        constexpr T operator()(const T& x, const T& y) const{
+            return y < x ? y : x;
+        }
+    };
+    struct max_op{
+        template<typename T>
+        constexpr T operator()(const T& x, const T& y) const{
+            return x < y ? y : x;
+        }
+    };
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
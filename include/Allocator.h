@@ -0,0 +1,319 @@
+/**
+ * @file    Allocator.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Allocators (storage policies) for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_ALLOCATOR_H
+#define DYNARRAY_ALLOCATOR_H
+
+#include<filesystem>
+#include<limits>
+#include<memory>
+#include<new>
+#include<numeric>
+#include<system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
+
+#include "Auxiliary.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Aligned allocator template.
+    //! @note  Example: vla::dynarray<double, 2, vla::aligned_allocator> a(n, m) : 64-byte aligned data().
+    //!                 vla::dynarray<double, 2, vla::padded_allocator>  a(n, m) : idem, w/ every row 64-byte aligned.
+    //!        If Padded is set, the innermost extent of an N-D array is padded to a multiple of Alignment bytes (see
+    //!        dynarray<T, N, A>::leading_dimension()), hence every row starts on a cache line/SIMD register boundary.
+    //!
+    template<typename T, size_t Alignment = 64U, bool Padded = false>
+    class aligned_allocator{
+        static_assert(Alignment >= alignof(T) && (Alignment & (Alignment-1U)) == 0U,
+                      "aligned_allocator<T, Alignment, Padded>: Alignment must be a power of 2 (>= alignof(T)).");
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using value_type                             = T;
+        using size_type                              = size_t;
+        using difference_type                        = size_d;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal                        = std::true_type;
+        template<typename U>
+        struct rebind{
+            using other = aligned_allocator<U, Alignment, Padded>;
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member constants.
+        //!
+        static constexpr size_t alignment = Alignment;                                              //!<Bytes.
+        static constexpr size_t padding   = Padded ? std::lcm(Alignment, sizeof(T))/sizeof(T) : 1U; //!<Elements.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        constexpr aligned_allocator() noexcept = default;
+        template<typename U>
+        constexpr aligned_allocator(const aligned_allocator<U, Alignment, Padded>&) noexcept{
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Allocate/deallocate n elements.
+        //!
+        [[nodiscard]] T* allocate(size_t n){
+            if(n > std::numeric_limits<size_t>::max()/sizeof(T)){
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(::operator new(n*sizeof(T), std::align_val_t{Alignment}));
+        }
+        void deallocate(T* p, size_t n) noexcept{
+            ::operator delete(p, n*sizeof(T), std::align_val_t{Alignment});
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator== .
+        //!                              operator!= .
+        //!
+        template<typename U>
+        friend bool operator==(const aligned_allocator&, const aligned_allocator<U, Alignment, Padded>&) noexcept{
+            return true;
+        }
+        template<typename U>
+        friend bool operator!=(const aligned_allocator&, const aligned_allocator<U, Alignment, Padded>&) noexcept{
+            return false;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Aligned allocator aliases.
+    //!
+    template<typename T>
+    using padded_allocator = aligned_allocator<T, 64U, true>; //!<64-byte aligned, padded rows.
+    //------------------------------------------------------------------------------------------------------------------
+#if defined(__unix__) || defined(__APPLE__)
+    //!
+    //! @brief Memory-mapped file modes/access hints.
+    //! @note  read_only     : PROT_READ, shared mapping (the file must be large enough; writing elements is undefined).
+    //!        read_write    : PROT_READ|PROT_WRITE, shared mapping (created/grown if needed; writes reach the file).
+    //!        copy_on_write : PROT_READ|PROT_WRITE, private mapping (writes are never written back).
+    //!
+    enum class map_mode{
+        read_only,
+        read_write,
+        copy_on_write
+    };
+    enum class map_access{
+        normal,
+        sequential,
+        random,
+        will_need,
+        dont_need
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief File mapping (shared by copies/rebinds of a mapped allocator).
+        //!
+        struct mapping{
+            std::filesystem::path path;
+            map_mode              mode;
+            size_t                offset;   //!<File offset (bytes).
+            map_access            access;
+            void*                 address;  //!<Mapped address (nullptr if not (yet) mapped, or no longer).
+            size_t                bytes;
+            bool                  consumed; //!<File mapped once already (later allocations are anonymous).
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief madvise(2) flags of access hint a.
+        //!
+        inline int advice(map_access a) noexcept{
+            switch(a){
+                case map_access::sequential : return MADV_SEQUENTIAL;
+                case map_access::random     : return MADV_RANDOM;
+                case map_access::will_need  : return MADV_WILLNEED;
+                case map_access::dont_need  : return MADV_DONTNEED;
+                default                     : return MADV_NORMAL;
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Memory-mapped (file-backed) allocator template.
+    //! @note  Example: using dynarray_m = vla::dynarray<double, 3, vla::mapped_allocator>
+    //!                 auto a = dynarray_m::map("u.bin", vla::map_mode::read_write, nx, ny, nz)
+    //!                 a.get_allocator().advise(vla::map_access::sequential)
+    //!                 a.get_allocator().flush()
+    //!        The first allocation of an allocator constructed from a path maps [offset, offset+n*sizeof(T)) of that
+    //!        file; every other allocation (e.g. copies of the array, see select_on_container_copy_construction) maps
+    //!        anonymous memory. Pages are read lazily (on first access) and written back by the OS or by flush(). Only
+    //!        trivially copyable types may be file-backed (elements are neither constructed nor destroyed, see
+    //!        dynarray<T, N, A>::map).
+    //!
+    template<typename T>
+    class mapped_allocator{
+        template<typename U>
+        friend class mapped_allocator;
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        std::shared_ptr<detail::mapping> mapping_; //!<File mapping (nullptr if anonymous).
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using value_type                             = T;
+        using size_type                              = size_t;
+        using difference_type                        = size_d;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+        using is_always_equal                        = std::false_type;
+        template<typename U>
+        struct rebind{
+            using other = mapped_allocator<U>;
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::mapped_allocator<double> a                                         : anonymous.
+        //!                 vla::mapped_allocator<double> a("u.bin", vla::map_mode::read_only)      : file-backed.
+        //!                 vla::mapped_allocator<double> a("u.bin", vla::map_mode::read_only, 64U) : from byte 64.
+        //!
+        mapped_allocator() noexcept = default;
+        explicit mapped_allocator(const std::filesystem::path& path, map_mode mode, size_t offset = 0U,
+                                  map_access access = map_access::normal) :
+            mapping_(std::make_shared<detail::mapping>(detail::mapping{path, mode, offset, access, nullptr, 0U,
+                                                                       false})){
+            if(offset%alignof(T) != 0U){
+                throw std::invalid_argument("mapped_allocator<T>::mapped_allocator(const path&, map_mode, size_t, "
+                                            "map_access)");
+            }
+        }
+        template<typename U>
+        mapped_allocator(const mapped_allocator<U>& other) noexcept : mapping_(other.mapping_){
+        }
+        mapped_allocator select_on_container_copy_construction() const noexcept{
+            return mapped_allocator();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Allocate/deallocate n elements.
+        //!
+        [[nodiscard]] T* allocate(size_t n){
+            if(n > std::numeric_limits<size_t>::max()/sizeof(T)){
+                throw std::bad_array_new_length();
+            }
+            const size_t bytes = n*sizeof(T);
+            if(mapping_ == nullptr || mapping_->consumed){
+                void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(p == MAP_FAILED){
+                    throw std::bad_alloc();
+                }
+                return static_cast<T*>(p);
+            }
+            detail::mapping& m = *mapping_;
+            const bool   writable = m.mode == map_mode::read_write;
+            const size_t delta    = m.offset%detail::index(::sysconf(_SC_PAGESIZE));
+            const int    fd       = ::open(m.path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+            if(fd < 0){
+                throw std::system_error(errno, std::generic_category(), "mapped_allocator<T>::allocate(size_t)");
+            }
+            struct stat st{};
+            const size_t size = ::fstat(fd, &st) == 0 ? detail::index(st.st_size) : 0U;
+            int error = 0;
+            if(size < m.offset+bytes){
+                if(!writable || ::ftruncate(fd, detail::convert<off_t>(m.offset+bytes)) != 0){
+                    error = writable ? errno : EINVAL;
+                }
+            }
+            void* p = MAP_FAILED;
+            if(error == 0){
+                p = ::mmap(nullptr, bytes+delta, m.mode == map_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE,
+                           m.mode == map_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED, fd,
+                           detail::convert<off_t>(m.offset-delta));
+                error = p == MAP_FAILED ? errno : 0;
+            }
+            ::close(fd);
+            if(error != 0){
+                throw std::system_error(error, std::generic_category(), "mapped_allocator<T>::allocate(size_t)");
+            }
+            m.address  = static_cast<char*>(p)+delta;
+            m.bytes    = bytes;
+            m.consumed = true;
+            advise(m.access);
+            return static_cast<T*>(m.address);
+        }
+        void deallocate(T* p, size_t n) noexcept{
+            size_t delta = 0U;
+            if(mapping_ != nullptr && mapping_->address == p){
+                delta = mapping_->offset%detail::index(::sysconf(_SC_PAGESIZE));
+                mapping_->address = nullptr;
+                mapping_->bytes   = 0U;
+            }
+            ::munmap(static_cast<char*>(static_cast<void*>(p))-delta, n*sizeof(T)+delta);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: advise (madvise(2) the file mapping).
+        //!                    flush  (msync(2) the file mapping, i.e. write dirty pages back to the file).
+        //!                    is_mapped.
+        //!
+        void advise(map_access access) const{
+            if(is_mapped()){
+                const size_t delta = mapping_->offset%detail::index(::sysconf(_SC_PAGESIZE));
+                mapping_->access   = access;
+                ::madvise(static_cast<char*>(mapping_->address)-delta, mapping_->bytes+delta, detail::advice(access));
+            }
+        }
+        void flush() const{
+            if(is_mapped() && mapping_->mode == map_mode::read_write){
+                const size_t delta = mapping_->offset%detail::index(::sysconf(_SC_PAGESIZE));
+                if(::msync(static_cast<char*>(mapping_->address)-delta, mapping_->bytes+delta, MS_SYNC) != 0){
+                    throw std::system_error(errno, std::generic_category(), "mapped_allocator<T>::flush() const");
+                }
+            }
+        }
+        bool is_mapped() const noexcept{
+            return mapping_ != nullptr && mapping_->address != nullptr;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator== .
+        //!                              operator!= .
+        //!
+        template<typename U>
+        friend bool operator==(const mapped_allocator& lhs, const mapped_allocator<U>& rhs) noexcept{
+            return lhs.mapping_ == rhs.mapping_;
+        }
+        template<typename U>
+        friend bool operator!=(const mapped_allocator& lhs, const mapped_allocator<U>& rhs) noexcept{
+            return lhs.mapping_ != rhs.mapping_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+#endif
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,409 @@
+/**
+ * @file    Arena.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Monotonic arena and size-class pool memory resources (std::pmr compatible).
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_ARENA_H
+#define DYNARRAY_ARENA_H
+
+#include<algorithm>
+#include<array>
+#include<bit>
+#include<cstddef>
+#include<limits>
+#include<memory>
+#include<memory_resource>
+#include<new>
+#include<type_traits>
+
+#include "Auxiliary.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Monotonic arena (memory resource).
+    //! @note  Example: vla::arena r(64U << 20);                  : 64 MiB region.
+    //!                 {
+    //!                     vla::resource_scope scope(r);
+    //!                     vla::dynarray<double, 3, vla::resource_allocator> a(nx, ny, nz); : allocated from r.
+    //!                     ...
+    //!                 }
+    //!                 r.release();                              : O(1), the region is reused by the next timestep.
+    //!        Allocation bumps a pointer and deallocation is a no-op: memory is only reclaimed by release() (or the
+    //!        destructor), hence arrays allocated from an arena must not outlive it nor be used after release().
+    //!        If the region is exhausted, a new chunk (twice as large) is requested from the upstream resource; the
+    //!        next release() merges all chunks into a single one. Not thread-safe.
+    //!
+    class arena : public std::pmr::memory_resource{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Chunk header (stored at the beginning of each chunk).
+        //!
+        struct alignas(std::max_align_t) chunk{
+            chunk* next;  //!<Previous (older) chunk.
+            size_t bytes; //!<Chunk size (incl. header).
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        std::pmr::memory_resource* upstream_; //!<Upstream resource.
+        chunk*                     head_;     //!<Current (newest) chunk.
+        std::byte*                 first_;    //!<Free range (begin).
+        std::byte*                 last_;     //!<Free range (end).
+        size_t                     used_;     //!<Bytes allocated (incl. alignment).
+        size_t                     capacity_; //!<Bytes reserved  (all chunks, excl. headers).
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        explicit arena(size_t bytes = 1U << 20,
+                       std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+            upstream_(upstream), head_(nullptr), first_(nullptr), last_(nullptr), used_(0U), capacity_(0U){
+            grow(bytes);
+        }
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor.
+        //!
+        ~arena() noexcept override{
+            free();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Modifiers: release (all allocations at once).
+        //!
+        void release(){
+            if(head_ != nullptr && head_->next != nullptr){
+                const size_t bytes = capacity_;
+                free();
+                grow(bytes);
+            }
+            else if(head_ != nullptr){
+                first_ = static_cast<std::byte*>(static_cast<void*>(head_+1));
+            }
+            used_ = 0U;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: used.
+        //!                  capacity.
+        //!
+        size_t used() const noexcept{
+            return used_;
+        }
+        size_t capacity() const noexcept{
+            return capacity_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory resource interface.
+        //!
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            void*  p     = first_;
+            size_t space = vla::detail::index(last_-first_);
+            if(std::align(alignment, bytes, p, space) == nullptr){
+                grow(std::max(2U*capacity_, bytes+alignment));
+                p     = first_;
+                space = vla::detail::index(last_-first_);
+                std::align(alignment, bytes, p, space);
+            }
+            std::byte* q = static_cast<std::byte*>(p)+bytes;
+            used_ += vla::detail::index(q-first_);
+            first_ = q;
+            return p;
+        }
+        void do_deallocate(void*, size_t, size_t) noexcept override{
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+            return this == &other;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Request a new chunk of (at least) bytes from upstream.
+        //!
+        void grow(size_t bytes){
+            bytes = std::max<size_t>(bytes, sizeof(chunk));
+            void* p = upstream_->allocate(sizeof(chunk)+bytes, alignof(chunk));
+            // Initialise...
+            head_      = ::new(p) chunk{head_, sizeof(chunk)+bytes};
+            first_     = static_cast<std::byte*>(static_cast<void*>(head_+1));
+            last_      = first_+bytes;
+            capacity_ += bytes;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Return all chunks to upstream.
+        //!
+        void free() noexcept{
+            while(head_ != nullptr){
+                chunk* next = head_->next;
+                upstream_->deallocate(head_, head_->bytes, alignof(chunk));
+                head_ = next;
+            }
+            first_    = nullptr;
+            last_     = nullptr;
+            capacity_ = 0U;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Size-class pool (memory resource).
+    //! @note  Example: vla::pool r;
+    //!                 vla::resource_scope scope(r);
+    //!                 for(...){vla::dynarray<double, 1, vla::resource_allocator> t(n); ...} : same block every time.
+    //!        Blocks of up to 64 KiB are served from per-size-class free lists (powers of 2 >= 16 bytes, carved from
+    //!        slabs requested from the upstream resource), larger ones go to upstream directly. Deallocated blocks
+    //!        are reused by the next allocation of the same class. Not thread-safe.
+    //!
+    class pool : public std::pmr::memory_resource{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary constants.
+        //!
+        static constexpr size_t classes  = 13U;        //!<Size classes (16 B, 32 B, ..., 64 KiB).
+        static constexpr size_t smallest = 16U;        //!<Smallest block (bytes).
+        static constexpr size_t slab     = 64U << 10;  //!<Slab size (bytes, >= 16 blocks).
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Free block (intrusive list) and slab header (stored in the first block(s) of each slab).
+        //!
+        struct node{
+            node* next;
+        };
+        struct header{
+            header* next;
+            size_t  bytes;
+            size_t  alignment;
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        std::pmr::memory_resource* upstream_; //!<Upstream resource.
+        std::array<node*, classes> free_;     //!<Free lists (per size class).
+        header*                    slabs_;    //!<Slabs.
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        explicit pool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept :
+            upstream_(upstream), free_{}, slabs_(nullptr){
+        }
+        pool(const pool&) = delete;
+        pool& operator=(const pool&) = delete;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor.
+        //!
+        ~pool() noexcept override{
+            release();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Modifiers: release (all slabs; large blocks must have been deallocated).
+        //!
+        void release() noexcept{
+            while(slabs_ != nullptr){
+                header* next = slabs_->next;
+                upstream_->deallocate(slabs_, slabs_->bytes, slabs_->alignment);
+                slabs_ = next;
+            }
+            free_.fill(nullptr);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory resource interface.
+        //!
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            const size_t k = size_class(bytes, alignment);
+            if(k == classes){
+                return upstream_->allocate(bytes, alignment);
+            }
+            if(free_[k] == nullptr){
+                refill(k);
+            }
+            node* p  = free_[k];
+            free_[k] = p->next;
+            return p;
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) noexcept override{
+            const size_t k = size_class(bytes, alignment);
+            if(k == classes){
+                upstream_->deallocate(p, bytes, alignment);
+            }
+            else{
+                free_[k] = ::new(p) node{free_[k]};
+            }
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+            return this == &other;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Size class of a block (classes if too large).
+        //!
+        static size_t size_class(size_t bytes, size_t alignment) noexcept{
+            const size_t s = std::bit_ceil(std::max({bytes, alignment, smallest}));
+            return std::min<size_t>(vla::detail::index(std::countr_zero(s/smallest)), classes);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Carve a new slab into blocks of class k (the first ceil(sizeof(header)/s) ones hold the slab header).
+        //!
+        void refill(size_t k){
+            const size_t s = smallest << k;
+            const size_t n = std::max<size_t>(slab/s, 16U);
+            const size_t h = (sizeof(header)+s-1U)/s;
+            std::byte*   p = static_cast<std::byte*>(upstream_->allocate(n*s, s));
+            slabs_ = ::new(p) header{slabs_, n*s, s};
+            for(size_t i = n-1U; i >= h; --i){
+                free_[k] = ::new(p+i*s) node{free_[k]};
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Current (thread-local) memory resource of default-constructed resource allocators.
+        //!
+        inline std::pmr::memory_resource*& current_resource() noexcept{
+            thread_local std::pmr::memory_resource* r = nullptr;
+            return r;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Memory resource scope: default-constructed resource allocators (of this thread) allocate from resource r
+    //!        until the scope ends (scopes nest).
+    //!
+    class resource_scope{
+    private:
+        std::pmr::memory_resource* previous_; //!<Enclosing scope's resource.
+    public:
+        explicit resource_scope(std::pmr::memory_resource& r) noexcept : previous_(detail::current_resource()){
+            detail::current_resource() = &r;
+        }
+        resource_scope(const resource_scope&) = delete;
+        resource_scope& operator=(const resource_scope&) = delete;
+        ~resource_scope() noexcept{
+            detail::current_resource() = previous_;
+        }
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Resource allocator template (allocates from a std::pmr::memory_resource, e.g. vla::arena or vla::pool).
+    //! @note  Example: vla::dynarray<double, 3, vla::resource_allocator> a(nx, ny, nz) : resource of the current
+    //!                 resource_scope (std::pmr::get_default_resource() if none).
+    //!        Unlike std::pmr::polymorphic_allocator, the resource is propagated on copy/move assignment and swap,
+    //!        and copies of an array allocate from the same resource as the original. Converts to/from
+    //!        std::pmr::polymorphic_allocator<T> (e.g. to feed a std::pmr::vector from the same arena).
+    //!
+    template<typename T>
+    class resource_allocator{
+    private:
+        std::pmr::memory_resource* resource_; //!<Memory resource.
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using value_type                             = T;
+        using size_type                              = size_t;
+        using difference_type                        = size_d;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+        using is_always_equal                        = std::false_type;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        resource_allocator() noexcept : resource_(detail::current_resource() != nullptr ?
+                                                  detail::current_resource() : std::pmr::get_default_resource()){
+        }
+        resource_allocator(std::pmr::memory_resource* resource) noexcept : resource_(resource){
+        }
+        template<typename U>
+        resource_allocator(const resource_allocator<U>& other) noexcept : resource_(other.resource()){
+        }
+        template<typename U>
+        resource_allocator(const std::pmr::polymorphic_allocator<U>& other) noexcept : resource_(other.resource()){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Conversion: std::pmr::polymorphic_allocator<U>.
+        //!
+        template<typename U>
+        operator std::pmr::polymorphic_allocator<U>() const noexcept{
+            return std::pmr::polymorphic_allocator<U>(resource_);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Allocate/deallocate n elements.
+        //!
+        [[nodiscard]] T* allocate(size_t n){
+            if(n > std::numeric_limits<size_t>::max()/sizeof(T)){
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(resource_->allocate(n*sizeof(T), alignof(T)));
+        }
+        void deallocate(T* p, size_t n) noexcept{
+            resource_->deallocate(p, n*sizeof(T), alignof(T));
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory resource.
+        //!
+        std::pmr::memory_resource* resource() const noexcept{
+            return resource_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator== .
+        //!                              operator!= .
+        //!
+        template<typename U>
+        friend bool operator==(const resource_allocator& lhs, const resource_allocator<U>& rhs) noexcept{
+            return *lhs.resource() == *rhs.resource();
+        }
+        template<typename U>
+        friend bool operator!=(const resource_allocator& lhs, const resource_allocator<U>& rhs) noexcept{
+            return !(lhs == rhs);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file    Auxiliary.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Auxiliary aliases and functions shared by the dynamic array headers.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_AUXILIARY_H
+#define DYNARRAY_AUXILIARY_H
+
+#include<algorithm>
+#include<bit>
+#include<cstddef>
+#include<cstring>
+#include<memory>
+#include<type_traits>
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary aliases.
+    //!
+    using size_d = std::ptrdiff_t; //!<Type difference alias.
+    using size_t = std::size_t;    //!<Type size       alias.
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary tags.
+    //! @note  Example: vla::dynarray<double, 3> a(vla::uninitialized, nx, ny, nz) : elements are left uninitialised.
+    //!                 vla::dynarray<double, 3> a(vla::default_init,  nx, ny, nz) : elements are default-initialised.
+    //!        vla::uninitialized only accepts trivial types; vla::default_init runs T's default constructor if it is
+    //!        non-trivial and is otherwise equivalent.
+    //!
+    struct uninitialized_t{
+        explicit uninitialized_t() = default;
+    };
+    struct default_init_t{
+        explicit default_init_t() = default;
+    };
+    inline constexpr uninitialized_t uninitialized{}; //!<Uninitialised       construction tag.
+    inline constexpr default_init_t  default_init{};  //!<Default-initialised construction tag.
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Index cast (avoids -Wuseless-cast for size_t arguments).
+        //!
+        template<typename I>
+        constexpr size_t index(I i) noexcept{
+            if constexpr(std::is_same_v<I, size_t>){
+                return i;
+            }
+            else{
+                return static_cast<size_t>(i);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Value cast (avoids -Wuseless-cast for same-type arguments).
+        //!
+        template<typename T, typename U>
+        constexpr T convert(const U& u){
+            if constexpr(std::is_same_v<T, U>){
+                return u;
+            }
+            else{
+                return static_cast<T>(u);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Innermost extent padding (elements) requested by the allocator (see aligned_allocator<T, ...>).
+        //!
+        template<typename A>
+        consteval size_t padding() noexcept{
+            if constexpr(requires{A::padding;}){
+                return A::padding;
+            }
+            else{
+                return 1U;
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether construct/destroy may bypass the allocator (i.e. it does not customise them).
+        //!
+        template<typename A, typename T, typename ... Args>
+        inline constexpr bool has_construct_v = requires(A& a, T* p, const Args& ... args){
+            a.construct(p, args...);
+        };
+        template<typename A, typename T>
+        inline constexpr bool has_destroy_v = requires(A& a, T* p){
+            a.destroy(p);
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether I is a (custom) element initialiser (see parallel::first_touch_t).
+        //! @note  An initialiser i constructs the elements of a newly allocated array: i(a, p, extents, stride, args...)
+        //!        constructs the n(0) blocks of stride elements each starting at p, w/ allocator a and arguments args.
+        //!
+        template<typename I>
+        inline constexpr bool is_initializer_v = requires{typename std::remove_cvref_t<I>::is_initializer;};
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Fill n elements w/ value (memset for byte-sized and all-zero values, vectorised stores otherwise).
+        //!
+        template<typename T>
+        void fill_n(T* p, size_t n, const T& value){
+            if constexpr(std::is_trivially_copyable_v<T>){
+                if constexpr(sizeof(T) == 1U){
+                    std::memset(static_cast<void*>(p), std::bit_cast<unsigned char>(value), n);
+                    return;
+                }
+                else{
+                    constexpr unsigned char zero[sizeof(T)] = {};
+                    if(std::memcmp(&value, zero, sizeof(T)) == 0){
+                        std::memset(static_cast<void*>(p), 0, n*sizeof(T));
+                        return;
+                    }
+                }
+            }
+            std::fill_n(p, n, value);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destroy n elements in reverse order (no-op for trivially destructible types).
+        //!
+        template<typename A, typename T>
+        void destroy_n(A& a, T* p, size_t n) noexcept{
+            if constexpr(!std::is_trivially_destructible_v<T> || has_destroy_v<A, T>){
+                for(size_t i = n; i > 0U; --i){
+                    std::allocator_traits<A>::destroy(a, p+i-1U);
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Construct n elements w/ args (memset/fill_n for trivially copyable types). If a constructor throws,
+        //!        the elements already constructed are destroyed.
+        //!
+        template<typename A, typename T, typename ... Args>
+        void construct_n(A& a, T* p, size_t n, const Args& ... args){
+            if constexpr(std::is_trivially_copyable_v<T> && !has_construct_v<A, T, Args...>){
+                if constexpr(sizeof ... (Args) == 0U && std::is_trivially_default_constructible_v<T>){
+                    std::memset(static_cast<void*>(p), 0, n*sizeof(T));
+                    return;
+                }
+                else if constexpr(sizeof ... (Args) == 1U && (std::is_same_v<Args, T> && ...)){
+                    detail::fill_n(p, n, args...);
+                    return;
+                }
+            }
+            size_t i = 0U;
+            try{
+                for(; i < n; ++i){
+                    std::allocator_traits<A>::construct(a, p+i, args...);
+                }
+            }
+            catch(...){
+                destroy_n(a, p, i);
+                throw;
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Default-initialise n elements (no-op for trivially default constructible types). If a constructor
+        //!        throws, the elements already constructed are destroyed.
+        //!
+        template<typename A, typename T>
+        void default_init_n(A& a, T* p, size_t n){
+            if constexpr(!std::is_trivially_default_constructible_v<T>){
+                size_t i = 0U;
+                try{
+                    for(; i < n; ++i){
+                        ::new(static_cast<void*>(p+i)) T;
+                    }
+                }
+                catch(...){
+                    destroy_n(a, p, i);
+                    throw;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy-construct n elements from src (single memcpy for trivially copyable types). If a copy
+        //!        constructor throws, the elements already constructed are destroyed.
+        //!
+        template<typename A, typename T>
+        void copy_n(A& a, const T* src, size_t n, T* p){
+            if constexpr(std::is_trivially_copyable_v<T> && !has_construct_v<A, T, T>){
+                std::memcpy(static_cast<void*>(p), src, n*sizeof(T));
+            }
+            else{
+                size_t i = 0U;
+                try{
+                    for(; i < n; ++i){
+                        std::allocator_traits<A>::construct(a, p+i, *(src+i));
+                    }
+                }
+                catch(...){
+                    destroy_n(a, p, i);
+                    throw;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Relocate (move-construct, then destroy) n elements from src to p (single memcpy for trivially
+        //!        copyable types). If a (copy/move) constructor throws, src is left intact.
+        //!
+        template<typename A, typename T>
+        void relocate_n(A& a, T* src, size_t n, T* p){
+            if(n == 0U){
+                return;
+            }
+            if constexpr(std::is_trivially_copyable_v<T> && !has_construct_v<A, T, T> && !has_destroy_v<A, T>){
+                std::memcpy(static_cast<void*>(p), static_cast<const void*>(src), n*sizeof(T));
+            }
+            else{
+                size_t i = 0U;
+                try{
+                    for(; i < n; ++i){
+                        std::allocator_traits<A>::construct(a, p+i, std::move_if_noexcept(*(src+i)));
+                    }
+                }
+                catch(...){
+                    destroy_n(a, p, i);
+                    throw;
+                }
+                destroy_n(a, src, n);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
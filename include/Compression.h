@@ -0,0 +1,659 @@
+/**
+ * @file    Compression.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Chunked compressed binary format (pluggable codecs, parallel coding) for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_COMPRESSION_H
+#define DYNARRAY_COMPRESSION_H
+
+#include<algorithm>
+#include<array>
+#include<cerrno>
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+#include<filesystem>
+#include<limits>
+#include<stdexcept>
+#include<system_error>
+#include<tuple>
+#include<type_traits>
+#include<vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include<fcntl.h>
+#include<sys/uio.h>
+#include<unistd.h>
+#endif
+
+#include "Auxiliary.h"
+#include "DynArray.h"
+#include "DynArrayView.h"
+#include "Parallel.h"
+#include "Serialization.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Codecs (compress/decompress one block of bytes, independently of the other blocks).
+    //! @note  A codec C provides: C::id                                 : identifier (stored in the file).
+    //!                            C::bound(n)                           : max. compressed size of n bytes.
+    //!                            C::compress(in, n, width, out)        : compressed size (bytes written to out).
+    //!                            C::decompress(in, m, width, out, n)   : n bytes (throws if in is corrupt).
+    //!        width is the element size (bytes). Blocks a codec does not shrink are stored raw, i.e. codecs need not
+    //!        handle incompressible data. Codecs are called concurrently (on different blocks), hence must be
+    //!        thread-safe. raw_codec stores blocks as they are; shuffle_lz_codec transposes the bytes of the
+    //!        elements (byte k of every element, then byte k+1, ...: exponents and high-order bytes of smooth fields
+    //!        form long runs) and compresses the result w/ an LZ77 coder (LZ4-like sequences, 64 KiB window).
+    //!
+    struct raw_codec{
+        static constexpr std::uint32_t id = 0U;
+        static size_t bound(size_t n) noexcept{
+            return n;
+        }
+        static size_t compress(const std::byte* in, size_t n, size_t, std::byte* out) noexcept{
+            std::memcpy(out, in, n);
+            return n;
+        }
+        static void decompress(const std::byte* in, size_t m, size_t, std::byte* out, size_t n){
+            if(m != n){
+                throw std::invalid_argument("vla::raw_codec::decompress(const byte*, size_t, size_t, byte*, size_t)");
+            }
+            std::memcpy(out, in, n);
+        }
+    };
+    struct shuffle_lz_codec{
+        static constexpr std::uint32_t id = 1U;
+        static size_t bound(size_t n) noexcept{
+            return n+n/255U+16U;
+        }
+        static size_t compress(const std::byte* in, size_t n, size_t width, std::byte* out){
+            std::vector<std::byte> s(n);
+            shuffle(in, n, width, s.data());
+            return lz_compress(s.data(), n, out);
+        }
+        static void decompress(const std::byte* in, size_t m, size_t width, std::byte* out, size_t n){
+            std::vector<std::byte> s(n);
+            lz_decompress(in, m, s.data(), n);
+            unshuffle(s.data(), n, width, out);
+        }
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions: shuffle/unshuffle (byte transposition of the n/width elements, trailing bytes
+        //!                             are copied).
+        //!                             lz_compress/lz_decompress.
+        //! @note  Sequence: token (literal length << 4 | match length-4, 15: continued in the following bytes, each
+        //!        255 adding 255 until one < 255), literals, match offset (2 bytes, little-endian, 1..65535). The last
+        //!        sequence has literals only (input end).
+        //!
+        static constexpr size_t hash_bits = 14U;
+        static constexpr size_t min_match = 4U;
+        static constexpr size_t window    = 65535U;
+
+        static void shuffle(const std::byte* in, size_t n, size_t width, std::byte* out) noexcept{
+            const size_t m = width == 0U ? 0U : n/width;
+            for(size_t b = 0U; b < width && m > 0U; ++b){
+                for(size_t i = 0U; i < m; ++i){
+                    out[b*m+i] = in[i*width+b];
+                }
+            }
+            std::memcpy(out+m*width, in+m*width, n-m*width);
+        }
+        static void unshuffle(const std::byte* in, size_t n, size_t width, std::byte* out) noexcept{
+            const size_t m = width == 0U ? 0U : n/width;
+            for(size_t b = 0U; b < width && m > 0U; ++b){
+                for(size_t i = 0U; i < m; ++i){
+                    out[i*width+b] = in[b*m+i];
+                }
+            }
+            std::memcpy(out+m*width, in+m*width, n-m*width);
+        }
+        static std::uint32_t read32(const std::byte* p) noexcept{
+            std::uint32_t x;
+            std::memcpy(&x, p, sizeof(x));
+            return x;
+        }
+        static std::byte* put_length(std::byte* o, size_t n) noexcept{
+            for(; n >= 255U; n -= 255U){
+                *o++ = std::byte{255U};
+            }
+            *o++ = static_cast<std::byte>(n);
+            return o;
+        }
+        static size_t get_length(const std::byte*& i, const std::byte* end){
+            size_t n = 0U;
+            for(;;){
+                if(i == end){
+                    throw std::invalid_argument("vla::shuffle_lz_codec::decompress(...)"); //!<Truncated.
+                }
+                const auto b = std::to_integer<size_t>(*i++);
+                n += b;
+                if(b != 255U){
+                    return n;
+                }
+            }
+        }
+        static std::byte* put_sequence(std::byte* o, const std::byte* l, size_t nl, size_t offset, size_t nm) noexcept{
+            const size_t em = nm == 0U ? 0U : nm-min_match;
+            *o++ = static_cast<std::byte>(std::min<size_t>(nl, 15U) << 4U | std::min<size_t>(em, 15U));
+            if(nl >= 15U){
+                o = put_length(o, nl-15U);
+            }
+            std::memcpy(o, l, nl);
+            o += nl;
+            if(nm != 0U){
+                *o++ = static_cast<std::byte>(offset & 0xFFU);
+                *o++ = static_cast<std::byte>(offset >> 8U);
+                if(em >= 15U){
+                    o = put_length(o, em-15U);
+                }
+            }
+            return o;
+        }
+        static size_t lz_compress(const std::byte* in, size_t n, std::byte* out){
+            std::vector<std::uint32_t> table(size_t{1} << hash_bits, 0U);
+            std::byte*   o      = out;
+            size_t       anchor = 0U, i = 0U;
+            const size_t limit  = n > 12U ? n-12U : 0U; //!<Tail: literals.
+            while(i < limit){
+                const std::uint32_t x = read32(in+i);
+                const size_t        h = (x*2654435761U) >> (32U-hash_bits);
+                const size_t        c = table[h];
+                table[h] = static_cast<std::uint32_t>(i);
+                if(c < i && i-c <= window && read32(in+c) == x){
+                    size_t m = min_match;
+                    while(i+m < n && in[c+m] == in[i+m]){
+                        ++m;
+                    }
+                    o = put_sequence(o, in+anchor, i-anchor, i-c, m);
+                    i += m;
+                    anchor = i;
+                }
+                else{
+                    i += 1U+((i-anchor) >> 6U); //!<Skip faster through incompressible data.
+                }
+            }
+            o = put_sequence(o, in+anchor, n-anchor, 0U, 0U);
+            return detail::index(o-out);
+        }
+        static void lz_decompress(const std::byte* in, size_t m, std::byte* out, size_t n){
+            const std::byte*  i    = in;
+            const std::byte*  iend = in+m;
+            std::byte*        o    = out;
+            std::byte* const  oend = out+n;
+            const char* const what = "vla::shuffle_lz_codec::decompress(const byte*, size_t, size_t, byte*, size_t)";
+            for(;;){
+                if(i == iend){
+                    throw std::invalid_argument(what);
+                }
+                const auto token = std::to_integer<size_t>(*i++);
+                size_t     nl    = token >> 4U;
+                if(nl == 15U){
+                    nl += get_length(i, iend);
+                }
+                if(nl > detail::index(iend-i) || nl > detail::index(oend-o)){
+                    throw std::invalid_argument(what);
+                }
+                std::memcpy(o, i, nl);
+                i += nl;
+                o += nl;
+                if(i == iend){
+                    break;
+                }
+                if(iend-i < 2){
+                    throw std::invalid_argument(what);
+                }
+                const size_t offset = std::to_integer<size_t>(i[0U]) | std::to_integer<size_t>(i[1U]) << 8U;
+                i += 2;
+                size_t nm = (token & 15U)+min_match;
+                if((token & 15U) == 15U){
+                    nm += get_length(i, iend);
+                }
+                if(offset == 0U || offset > detail::index(o-out) || nm > detail::index(oend-o)){
+                    throw std::invalid_argument(what);
+                }
+                if(offset >= nm){
+                    std::memcpy(o, o-offset, nm);
+                    o += nm;
+                }
+                else{
+                    for(const std::byte* s = o-offset; nm > 0U; --nm){
+                        *o++ = *s++;                    //!<Overlapping (run-length) match.
+                    }
+                }
+            }
+            if(o != oend){
+                throw std::invalid_argument(what);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Chunked format (version 1).
+        //! @note  Offset       Bytes         Field
+        //!        0            8             magic ("DYNCHUNK").
+        //!        8            4             version.
+        //!        12           4             endianness (0x01020304 in the writer's byte order).
+        //!        16           4             element type (see type_code<T>).
+        //!        20           4             rank (N).
+        //!        24           4             codec (C::id).
+        //!        28           4             reserved (0).
+        //!        32           8             block size (elements).
+        //!        40           8             number of blocks (b).
+        //!        48           8*N           extents n(0), n(1), ...
+        //!        48+8*N       8*(b+1)       block offsets (bytes from the file start; the last one is the file size).
+        //!        ...          ...           blocks (block k: elements [k*block, (k+1)*block) of the row-major array).
+        //!        A block is stored raw if its stored size equals its raw size (always smaller otherwise).
+        //!
+        struct chunked_header{
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t endian;
+            std::uint32_t type;
+            std::uint32_t rank;
+            std::uint32_t codec;
+            std::uint32_t reserved;
+            std::uint64_t block;
+            std::uint64_t blocks;
+        };
+        inline constexpr char          chunked_magic[8] = {'D', 'Y', 'N', 'C', 'H', 'U', 'N', 'K'};
+        inline constexpr std::uint32_t chunked_version  = 1U;
+        //--------------------------------------------------------------------------------------------------------------
+#if defined(__unix__) || defined(__APPLE__)
+        //!
+        //! @brief Positioned read (pread) of n bytes at offset.
+        //!
+        inline void read_at(int fd, void* p, size_t n, size_t offset, const char* what){
+            auto* q = static_cast<char*>(p);
+            while(n > 0U){
+                const ssize_t k = ::pread(fd, q, n, convert<off_t>(offset));
+                if(k < 0){
+                    if(errno == EINTR){
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), what);
+                }
+                if(k == 0){
+                    throw std::system_error(std::make_error_code(std::errc::io_error), what); //!<Truncated file.
+                }
+                q      += k;
+                n      -= index(k);
+                offset += index(k);
+            }
+        }
+#endif
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+#if defined(__unix__) || defined(__APPLE__)
+    //!
+    //! @brief Save arrays (views) in the chunked compressed format.
+    //! @note  Example: vla::save_compressed("u.dcz", a)                                : 256 KiB blocks, shuffle+LZ.
+    //!                 vla::save_compressed<vla::raw_codec>("u.dcz", a, 1U << 20U)   : 1 MiB blocks, uncompressed.
+    //!                 vla::save_compressed("u.dcz", a, 1U << 18U, {.pool = &p})     : on pool p.
+    //!        The array is split into blocks of block bytes (rounded down to whole elements) of its row-major
+    //!        element sequence, compressed concurrently (one block per task, unless p.grain is set) and written w/ a
+    //!        single writev. Non-contiguous views are copied first. See compressed_reader to read them back.
+    //!
+    template<typename C = shuffle_lz_codec, typename X>
+    void save_compressed(const std::filesystem::path& path, const X& x, size_t block = 262144U,
+                         const parallel::policy& p = {}){
+        const auto v = detail::view_of(x);
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(v.data())>>;
+        constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>>;
+        static_assert(std::is_trivially_copyable_v<T>, "vla::save_compressed: T must be trivially copyable.");
+        const char* const what = "vla::save_compressed(const path&, const X&, size_t, const parallel::policy&)";
+        if(block == 0U || block > std::numeric_limits<std::uint32_t>::max()){
+            throw std::invalid_argument(what);
+        }
+        // Contiguous elements...
+        std::vector<T> copy;
+        const T* data = v.data();
+        if(!v.is_contiguous()){
+            copy.reserve(v.size());
+            detail::for_each_block(v, [&copy](const T* q, size_t n){
+                copy.insert(copy.end(), q, q+n);
+            });
+            data = copy.data();
+        }
+        // Compress blocks...
+        const size_t b      = std::max<size_t>(block/sizeof(T), 1U);
+        const size_t blocks = (v.size()+b-1U)/b;
+        std::vector<std::vector<std::byte>> stored(blocks);
+        parallel::for_range(blocks, [&](size_t first, size_t last){
+            for(size_t k = first; k < last; ++k){
+                const size_t n  = std::min(b, v.size()-k*b)*sizeof(T);
+                const auto*  in = static_cast<const std::byte*>(static_cast<const void*>(data+k*b));
+                auto&        s  = stored[k];
+                s.resize(C::bound(n));
+                const size_t m = C::compress(in, n, sizeof(T), s.data());
+                if(m < n){
+                    s.resize(m);
+                }
+                else{
+                    s.assign(in, in+n);
+                }
+            }
+        }, p);
+        // Header, extents and block offsets...
+        detail::chunked_header h{};
+        std::memcpy(h.magic, detail::chunked_magic, sizeof(h.magic));
+        h.version = detail::chunked_version;
+        h.endian  = detail::format_endian;
+        h.type    = detail::type_code<T>();
+        h.rank    = static_cast<std::uint32_t>(N);
+        h.codec   = C::id;
+        h.block   = b;
+        h.blocks  = blocks;
+        std::vector<std::uint64_t> index(N+blocks+1U);
+        std::copy(v.extents().begin(), v.extents().end(), index.begin());
+        index[N] = sizeof(h)+index.size()*sizeof(std::uint64_t);
+        for(size_t k = 0U; k < blocks; ++k){
+            index[N+k+1U] = index[N+k]+stored[k].size();
+        }
+        std::vector<iovec> blocks_io;
+        blocks_io.reserve(blocks+2U);
+        blocks_io.push_back({&h, sizeof(h)});
+        blocks_io.push_back({index.data(), index.size()*sizeof(std::uint64_t)});
+        for(auto& s : stored){
+            blocks_io.push_back({s.data(), s.size()});
+        }
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0){
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+        try{
+            detail::transfer<true>(fd, blocks_io.data(), blocks_io.size(), what);
+        }
+        catch(...){
+            ::close(fd);
+            throw;
+        }
+        if(::close(fd) != 0){
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Chunked compressed format reader template (whole array or sub-box, random access by block).
+    //! @note  Example: vla::compressed_reader<double, 3> r("u.dcz")
+    //!                 r.read(a)                            : whole array (extents r.extents()).
+    //!                 r.read({i0, j0, k0}, b)              : sub-box [i0, i0+b.extent(0)) x [j0, ...) x [k0, ...).
+    //!        Only the blocks overlapping the requested elements are read and decoded, concurrently (one block per
+    //!        task, unless p.grain is set). The element type, rank and codec C must match the file's. Files written
+    //!        on a machine of the opposite byte order are converted (arithmetic types only).
+    //!
+    template<typename T, size_t N = 1U, typename C = shuffle_lz_codec>
+    class compressed_reader{
+        static_assert(std::is_trivially_copyable_v<T>, "compressed_reader<T, N, C>: T must be trivially copyable.");
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using TYPE_E = std::array<size_t, N>; //!<Type extents alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        int                        fd_;      //!<File descriptor.
+        TYPE_E                     extents_; //!<Extents.
+        TYPE_E                     strides_; //!<Strides (row-major).
+        size_t                     size_;    //!<Number of elements.
+        size_t                     block_;   //!<Block size (elements).
+        std::vector<std::uint64_t> offsets_; //!<Block offsets (bytes, blocks+1).
+        bool                       swap_;    //!<Opposite byte order.
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (reads and validates the header and the block offsets).
+        //!
+        explicit compressed_reader(const std::filesystem::path& path) :
+            fd_(-1), extents_{}, strides_{}, size_(0U), block_(0U), swap_(false){
+            const char* const what = "compressed_reader<T, N, C>::compressed_reader(const path&)";
+            fd_ = ::open(path.c_str(), O_RDONLY);
+            if(fd_ < 0){
+                throw std::system_error(errno, std::generic_category(), what);
+            }
+            try{
+                detail::chunked_header h{};
+                std::array<std::uint64_t, N> n{};
+                detail::read_at(fd_, &h, sizeof(h), 0U, what);
+                if(std::memcmp(h.magic, detail::chunked_magic, sizeof(h.magic)) != 0){
+                    throw std::invalid_argument(what);
+                }
+                detail::read_at(fd_, n.data(), sizeof(n), sizeof(h), what);
+                if(h.endian != detail::format_endian){
+                    swap_     = true;
+                    h.version = detail::byteswap(h.version);
+                    h.endian  = detail::byteswap(h.endian);
+                    h.type    = detail::byteswap(h.type);
+                    h.rank    = detail::byteswap(h.rank);
+                    h.codec   = detail::byteswap(h.codec);
+                    h.block   = detail::byteswap(h.block);
+                    h.blocks  = detail::byteswap(h.blocks);
+                    for(auto& x : n){
+                        x = detail::byteswap(x);
+                    }
+                }
+                if(h.endian != detail::format_endian || h.version > detail::chunked_version ||
+                   h.type != detail::type_code<T>() || h.rank != N || h.codec != C::id || h.block == 0U ||
+                   (swap_ && !std::is_arithmetic_v<T>)){
+                    throw std::invalid_argument(what);
+                }
+                size_ = 1U;
+                for(size_t k = N; k-- > 0U;){
+                    extents_[k] = detail::convert<size_t>(n[k]);
+                    strides_[k] = size_;
+                    size_      *= extents_[k];
+                }
+                block_ = detail::convert<size_t>(h.block);
+                if(h.blocks != (size_+block_-1U)/block_){
+                    throw std::invalid_argument(what);
+                }
+                offsets_.resize(detail::convert<size_t>(h.blocks)+1U);
+                detail::read_at(fd_, offsets_.data(), offsets_.size()*sizeof(std::uint64_t), sizeof(h)+sizeof(n), what);
+                for(auto& x : offsets_){
+                    x = swap_ ? detail::byteswap(x) : x;
+                }
+                if(!std::is_sorted(offsets_.begin(), offsets_.end())){
+                    throw std::invalid_argument(what);
+                }
+            }
+            catch(...){
+                ::close(fd_);
+                throw;
+            }
+        }
+        compressed_reader(const compressed_reader&) = delete;
+        compressed_reader& operator=(const compressed_reader&) = delete;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor.
+        //!
+        ~compressed_reader() noexcept{
+            ::close(fd_);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: extents.
+        //!                  size.
+        //!                  blocks           (number of blocks).
+        //!                  block_size       (elements per block).
+        //!                  compressed_bytes (stored size of the blocks).
+        //!
+        const TYPE_E& extents() const noexcept{
+            return extents_;
+        }
+        size_t size() const noexcept{
+            return size_;
+        }
+        size_t blocks() const noexcept{
+            return offsets_.size()-1U;
+        }
+        size_t block_size() const noexcept{
+            return block_;
+        }
+        size_t compressed_bytes() const noexcept{
+            return detail::convert<size_t>(offsets_.back()-offsets_.front());
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: read (whole array, extents of x must be extents()).
+        //!                    read (sub-box of extents x.extents() starting at first).
+        //!
+        template<typename X>
+        void read(X&& x, const parallel::policy& p = {}){
+            if(detail::view_of(x).extents() != extents_){
+                throw std::invalid_argument("compressed_reader<T, N, C>::read(X&&, const parallel::policy&)");
+            }
+            read(TYPE_E{}, x, p);
+        }
+        template<typename X>
+        void read(const TYPE_E& first, X&& x, const parallel::policy& p = {}){
+            const auto v = detail::view_of(x);
+            static_assert(std::is_same_v<std::remove_pointer_t<decltype(v.data())>, T> &&
+                          std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>> == N,
+                          "compressed_reader<T, N, C>::read: X must be a (non-constant) T array (view) of rank N.");
+            for(size_t k = 0U; k < N; ++k){
+                if(first[k] > extents_[k] || v.extent(k) > extents_[k]-first[k]){
+                    throw std::out_of_range(
+                        "compressed_reader<T, N, C>::read(const TYPE_E&, X&&, const parallel::policy&)");
+                }
+            }
+            if(v.empty()){
+                return;
+            }
+            // Whole array into contiguous storage: decode in place...
+            if(v.extents() == extents_ && v.is_contiguous()){
+                parallel::for_range(blocks(), [&](size_t lo, size_t hi){
+                    for(size_t k = lo; k < hi; ++k){
+                        decode(k, v.data()+k*block_);
+                    }
+                }, p);
+                return;
+            }
+            // Blocks overlapping the sub-box...
+            constexpr size_t npos = std::numeric_limits<size_t>::max();
+            std::vector<size_t> slot(blocks(), npos), needed;
+            const size_t n = v.extent(N-1U);
+            for_each_row(first, v, [&](const TYPE_E&, size_t s){
+                for(size_t k = s/block_; k <= (s+n-1U)/block_; ++k){
+                    if(slot[k] == npos){
+                        slot[k] = needed.size();
+                        needed.push_back(k);
+                    }
+                }
+            });
+            std::vector<T> buffer(needed.size()*block_);
+            parallel::for_range(needed.size(), [&](size_t lo, size_t hi){
+                for(size_t k = lo; k < hi; ++k){
+                    decode(needed[k], buffer.data()+k*block_);
+                }
+            }, p);
+            // ...copied row by row.
+            const size_t stride = v.stride(N-1U);
+            for_each_row(first, v, [&](const TYPE_E& idx, size_t s){
+                T* row = &v(idx);
+                for(size_t j = 0U; j < n; ++j){
+                    row[j*stride] = buffer[slot[(s+j)/block_]*block_+(s+j)%block_];
+                }
+            });
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions: decode   (block k into out).
+        //!                             for_each_row (call f(idx, s) for each innermost row idx of view v, where s is
+        //!                                           the file's (row-major) index of its first element, v being at
+        //!                                           offset first).
+        //!
+        void decode(size_t k, T* out) const{
+            const char* const what = "compressed_reader<T, N, C>::decode(size_t, T*)";
+            const size_t n = std::min(block_, size_-k*block_)*sizeof(T);
+            const size_t m = detail::convert<size_t>(offsets_[k+1U]-offsets_[k]);
+            auto* o = static_cast<std::byte*>(static_cast<void*>(out));
+            if(m == n){
+                detail::read_at(fd_, o, n, detail::convert<size_t>(offsets_[k]), what);
+            }
+            else if(m < n){
+                std::vector<std::byte> s(m);
+                detail::read_at(fd_, s.data(), m, detail::convert<size_t>(offsets_[k]), what);
+                C::decompress(s.data(), m, sizeof(T), o, n);
+            }
+            else{
+                throw std::invalid_argument(what);
+            }
+            if constexpr(std::is_arithmetic_v<T>){
+                if(swap_){
+                    for(size_t j = 0U; j < n/sizeof(T); ++j){
+                        out[j] = detail::byteswap(out[j]);
+                    }
+                }
+            }
+        }
+        template<typename V, typename F>
+        void for_each_row(const TYPE_E& first, const V& v, F&& f) const{
+            TYPE_E idx{};
+            for(size_t r = v.size()/v.extent(N-1U); r > 0U; --r){
+                size_t s = 0U;
+                for(size_t k = 0U; k < N; ++k){
+                    s += (first[k]+idx[k])*strides_[k];
+                }
+                f(idx, s);
+                for(size_t k = N-1U; k > 0U; --k){
+                    if(++idx[k-1U] < v.extent(k-1U)){
+                        break;
+                    }
+                    idx[k-1U] = 0U;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Load arrays saved w/ save_compressed.
+    //! @note  Example: auto a = vla::load_compressed<double, 3>("u.dcz") : into a new array.
+    //!                 vla::load_compressed("u.dcz", a)                 : into an existing array (same extents).
+    //!
+    template<typename T, size_t N = 1U, typename C = shuffle_lz_codec, template<typename U> typename A = std::allocator>
+    dynarray<T, N, A> load_compressed(const std::filesystem::path& path, const parallel::policy& p = {}){
+        compressed_reader<T, N, C> r(path);
+        auto a = std::apply([](auto ... n){
+            if constexpr(std::is_trivially_default_constructible_v<T>){
+                return dynarray<T, N, A>(default_init, n...);
+            }
+            else{
+                return dynarray<T, N, A>(n...);
+            }
+        }, r.extents());
+        r.read(a, p);
+        return a;
+    }
+    template<typename C = shuffle_lz_codec, typename X>
+    requires(!std::is_same_v<std::remove_cvref_t<X>, parallel::policy>)
+    void load_compressed(const std::filesystem::path& path, X&& x, const parallel::policy& p = {}){
+        const auto v = detail::view_of(x);
+        using T = std::remove_pointer_t<decltype(v.data())>;
+        constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>>;
+        compressed_reader<T, N, C> r(path);
+        r.read(v, p);
+    }
+#endif
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
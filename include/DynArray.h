@@ -9,19 +9,27 @@
 #ifndef DYNARRAY_DYNARRAY_H
 #define DYNARRAY_DYNARRAY_H
 
+#include<array>
+#include<filesystem>
 #include<iostream>
+#include<limits>
+#include<memory>
 #include<stdexcept>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+
+#include "Allocator.h"
+#include "Auxiliary.h"
+#include "DynArrayView.h"
+#include "Expression.h"
 
 namespace vla{
-    //------------------------------------------------------------------------------------------------------------------
-    //!
-    //! @brief Auxiliary aliases.
-    //!
-    using size_d = std::ptrdiff_t; //!<Type difference alias.
-    using size_t = std::size_t;    //!<Type size       alias.
     //------------------------------------------------------------------------------------------------------------------
     //!
     //! @brief N-D (dynamic) array template.
+    //! @note  Elements are stored in a single contiguous (row-major) array. Element (i(0), i(1), ...) lives at offset
+    //!        i(0)*s(0)+i(1)*s(1)+..., where s(k) = n(k+1)*n(k+2)*... is the stride of dimension k.
     //!
     template<typename T, size_t N = 1U, template<typename U> typename A = std::allocator>
     class dynarray{
@@ -30,30 +38,29 @@ namespace vla{
         //!
         //! @brief Type aliases.
         //!
-        using       type_v =       T;                    //!<         Type value      alias (contig. array).
-        using const_type_v = const T;                    //!<Constant type value      alias (contig. array).
-        using       type_p =       type_v*;              //!<         Type pointer    alias (contig. array).
-        using const_type_p = const type_v*;              //!<Constant type pointer    alias (contig. array).
-        using       type_a =     A<type_v>;              //!<         Type allocator  alias (contig. array).
-        using       TYPE_V =       dynarray<T, N-1U, A>; //!<         Type value      alias (        array block(s)).
-        using const_TYPE_V = const dynarray<T, N-1U, A>; //!<Constant type value      alias (        array block(s)).
-        using       TYPE_P =       TYPE_V*;              //!<         Type pointer    alias (        array block(s)).
-        using const_TYPE_P = const TYPE_V*;              //!<Constant type pointer    alias (        array block(s)).
-        using       TYPE_R =       TYPE_V&;              //!<         Type reference  alias (        array block(s)).
-        using const_TYPE_R = const TYPE_V&;              //!<Constant type reference  alias (        array block(s)).
-        using       TYPE_A =     A<TYPE_V>;              //!<         Type allocator  alias (        array block(s)).
+        using       type_v =       T;                            //!<         Type value      alias (contig. array).
+        using const_type_v = const T;                            //!<Constant type value      alias (contig. array).
+        using       type_p =       type_v*;                      //!<         Type pointer    alias (contig. array).
+        using const_type_p = const type_v*;                      //!<Constant type pointer    alias (contig. array).
+        using       type_r =       type_v&;                      //!<         Type reference  alias (contig. array).
+        using const_type_r = const type_v&;                      //!<Constant type reference  alias (contig. array).
+        using       type_a =     A<type_v>;                      //!<         Type allocator  alias (contig. array).
+        using       TYPE_V =       dynarray_view<      T, N-1U>; //!<         Type view       alias (array block(s)).
+        using const_TYPE_V =       dynarray_view<const T, N-1U>; //!<Constant type view       alias (array block(s)).
+        using       TYPE_E =       std::array<size_t, N>;        //!<         Type extents    alias.
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Member variables.
         //!
         size_t size_;      //!<Type              size.           //!<n(0)*n(1)*n(2)*...
+        size_t span_;      //!<Type              span.           //!<s(0)*n(0) (>= size_ if padded).
+        size_t capacity_;  //!<Type              capacity.       //!<>= span_.
         type_a allocator_; //!<Type              allocator.
         type_p data_;      //!<Type (pointer to) data (content).
         type_p head_;      //!<Type (pointer to) head.
         type_p tail_;      //!<Type (pointer to) tail.
-        size_t SIZE_;      //!<Type              size (N).       //!<n.
-        TYPE_A ALLOCATOR_; //!<Type              allocator.
-        TYPE_P DATA_;      //!<Type (pointer to) data (content).
+        TYPE_E extents_;   //!<Type              extents.        //!<n(0), n(1), n(2), ...
+        TYPE_E strides_;   //!<Type              strides.        //!<n(1)*n(2)*..., n(2)*..., ..., 1 (if not padded).
         //--------------------------------------------------------------------------------------------------------------
     public:
         //--------------------------------------------------------------------------------------------------------------
@@ -69,146 +76,571 @@ namespace vla{
         //!
         explicit dynarray() noexcept{
             // Initialise...
-            size_ = 0U;
-            data_ = nullptr;
-            head_ = nullptr;
-            tail_ = nullptr;
-            SIZE_ = 0U;
-            DATA_ = nullptr;
+            size_     = 0U;
+            span_     = 0U;
+            capacity_ = 0U;
+            data_     = nullptr;
+            head_     = nullptr;
+            tail_     = nullptr;
+            extents_.fill(0U);
+            strides_.fill(0U);
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Constructor.
+        //! @note  Example: vla::dynarray<int, 3> a(1U, 2U, 3U)    : 1x2x3-element (integer) array filled with 0's.
+        //!                 vla::dynarray<int, 3> a(1U, 2U, 3U, 4) : 1x2x3-element (integer) array filled with 4's.
+        //!        The first N arguments are the extents, the remaining ones are forwarded to each element's constructor.
         //!
         template<typename ... Args>
         explicit dynarray(size_t n, Args&& ... args){
             // Check the number of (input) arguments...
-            if(1U+sizeof ... (args) < N){
+            if constexpr(1U+sizeof ... (args) < N){
                 throw std::invalid_argument("dynarray<T, N, A>::dynarray(size_t, Args&& ...)");
             }
-            // Get size of contig. array.
-            size_ = n*TYPE_V::get(std::forward<Args>(args)...);
-            SIZE_ = n;
+            else{
+                // Get extents, strides and size of contig. array.
+                init(std::forward_as_tuple(n, args...), std::make_index_sequence<N>{});
+
+                if(size_ == 0U){
+                    // Initialise...
+                    data_ = nullptr;
+                    head_ = nullptr;
+                    tail_ = nullptr;
+                }
+                else{
+                    if(span_ >= max_size()){
+                        throw std::invalid_argument("dynarray<T, N, A>::dynarray(size_t, Args&& ...)");
+                    }
+                    // Initialise...
+                    data_ = allocator_.allocate(span_); //!<Allocate s(0)*n(0) elements (contig. array).
+                    head_ = data_;
+                    tail_ = head_+span_-1U;
+                    // Construct...
+                    try{
+                        construct(std::forward_as_tuple(n, args...),
+                                  std::make_index_sequence<1U+sizeof ... (args)-N>{});
+                    }
+                    catch(...){
+                        allocator_.deallocate(data_, capacity_);
+                        throw;
+                    }
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (uninitialised/default-initialised elements).
+        //! @note  Example: vla::dynarray<double, 3> a(vla::uninitialized, 1U, 2U, 3U) : no element is written.
+        //!                 vla::dynarray<double, 3> a(vla::default_init,  1U, 2U, 3U) : idem (T is trivial).
+        //!
+        template<typename ... Args> requires(1U+sizeof ... (Args) == N)
+        explicit dynarray(uninitialized_t, size_t n, Args ... args) : dynarray(default_init, n, args...){
+            static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                          "dynarray<T, N, A>::dynarray(uninitialized_t, size_t, Args ...): T must be trivial.");
+        }
+        template<typename ... Args> requires(1U+sizeof ... (Args) == N)
+        explicit dynarray(default_init_t, size_t n, Args ... args){
+            // Get extents, strides and size of contig. array.
+            init(std::forward_as_tuple(n, args...), std::make_index_sequence<N>{});
 
             if(size_ == 0U){
                 // Initialise...
                 data_ = nullptr;
                 head_ = nullptr;
                 tail_ = nullptr;
-                DATA_ = nullptr;
             }
             else{
-                if(size_ >= max_size()){
-                    throw std::invalid_argument("dynarray<T, N, A>::dynarray(size_t, Args&& ...)");
+                if(span_ >= max_size()){
+                    throw std::invalid_argument("dynarray<T, N, A>::dynarray(default_init_t, size_t, Args ...)");
                 }
                 // Initialise...
-                data_ = allocator_.allocate(size_); //!<Allocate n elements (contig. array).
+                data_ = allocator_.allocate(span_);
                 head_ = data_;
-                tail_ = head_+size_-1U;
-                DATA_ = ALLOCATOR_.allocate(SIZE_); //!<Allocate n blocks.
-                // For each block...
-                for(size_t i = 0U; i < SIZE_; ++i){
-                    std::allocator_traits<TYPE_A>::construct(ALLOCATOR_, DATA_+i);
-                    (DATA_+i)->allocator_ = allocator_;
-                    (DATA_+i)->set(data_+i*size_/n, std::forward<Args>(args)...);
+                tail_ = head_+span_-1U;
+                // Construct...
+                try{
+                    detail::default_init_n(allocator_, data_, span_);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
                 }
             }
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
-        //! @brief Destructor.
+        //! @brief Constructor (custom element initialiser).
+        //! @note  Example: vla::dynarray<double, 3> a(vla::parallel::first_touch, 1U, 2U, 3U, 1.0) : see Parallel.h.
+        //!        The first N arguments following the initialiser are the extents, the remaining ones are forwarded to
+        //!        each element's constructor (see detail::is_initializer_v).
         //!
-        ~dynarray() noexcept{
-            if(DATA_ != nullptr){
-                for(size_t i = SIZE_; i > 0U; --i){
-                    std::allocator_traits<TYPE_A>::destroy(ALLOCATOR_, DATA_+i-1U);
+        template<typename I, typename ... Args> requires(detail::is_initializer_v<I> && sizeof ... (Args)+1U >= N)
+        explicit dynarray(const I& initializer, size_t n, Args&& ... args){
+            // Get extents, strides and size of contig. array.
+            init(std::forward_as_tuple(n, args...), std::make_index_sequence<N>{});
+
+            if(size_ == 0U){
+                // Initialise...
+                data_ = nullptr;
+                head_ = nullptr;
+                tail_ = nullptr;
+            }
+            else{
+                if(span_ >= max_size()){
+                    throw std::invalid_argument("dynarray<T, N, A>::dynarray(const I&, size_t, Args&& ...)");
+                }
+                // Initialise...
+                data_ = allocator_.allocate(span_);
+                head_ = data_;
+                tail_ = head_+span_-1U;
+                // Construct...
+                try{
+                    construct(initializer, std::forward_as_tuple(n, args...),
+                              std::make_index_sequence<1U+sizeof ... (args)-N>{});
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
                 }
-                ALLOCATOR_.deallocate(DATA_, SIZE_);
             }
-            if(data_ != nullptr){
-                for(size_t i = size_; i > 0U; --i){
-                    std::allocator_traits<type_a>::destroy(allocator_, data_+i-1U);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Factory (storage mapped by the allocator, e.g. a file; elements are not initialised).
+        //! @note  Example: auto a = vla::dynarray<double, 3, vla::mapped_allocator>::map("u.bin", read_only, 1U, 2U, 3U)
+        //!                 auto a = vla::dynarray<double, 3, vla::mapped_allocator>::map(allocator, 1U, 2U, 3U)
+        //!        The array adopts the first allocation of (a copy of) allocator as is, i.e. a file-backed array
+        //!        exposes the file content w/o reading it. See vla::mapped_allocator.
+        //!
+        template<typename ... Idx> requires(1U+sizeof ... (Idx) == N)
+        static dynarray map(const type_a& allocator, size_t n, Idx ... idx){
+            static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                          "dynarray<T, N, A>::map(const type_a&, size_t, Idx ...): T must be trivially copyable.");
+            dynarray a;
+            a.allocator_ = allocator;
+            // Get extents, strides and size of contig. array.
+            a.init(std::forward_as_tuple(n, idx...), std::make_index_sequence<N>{});
+
+            if(a.size_ != 0U){
+                if(a.span_ >= a.max_size()){
+                    throw std::invalid_argument("dynarray<T, N, A>::map(const type_a&, size_t, Idx ...)");
                 }
-                allocator_.deallocate(data_, size_);
+                // Initialise...
+                a.data_ = a.allocator_.allocate(a.span_);
+                a.head_ = a.data_;
+                a.tail_ = a.head_+a.span_-1U;
             }
+            return a;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        template<typename ... Idx> requires(1U+sizeof ... (Idx) == N &&
+                                            std::is_constructible_v<type_a, const std::filesystem::path&, map_mode>)
+        static dynarray map(const std::filesystem::path& path, map_mode mode, size_t n, Idx ... idx){
+            return map(type_a(path, mode), n, idx...);
         }
+#endif
         //--------------------------------------------------------------------------------------------------------------
         //!
-        //! @brief Template class.
+        //! @brief Copy constructor (deep copy).
+        //! @note  Example: vla::dynarray<int, 2> a(b) <=> vla::dynarray<int, 2> a = b.
+        //!        Trivially copyable types are copied w/ a single memcpy of the contig. array.
+        //!
+        dynarray(const dynarray& other) :
+            allocator_(std::allocator_traits<type_a>::select_on_container_copy_construction(other.allocator_)){
+            // Initialise...
+            size_     = other.size_;
+            span_     = other.span_;
+            capacity_ = other.span_;
+            extents_  = other.extents_;
+            strides_  = other.strides_;
+            if(size_ == 0U){
+                data_ = nullptr;
+                head_ = nullptr;
+                tail_ = nullptr;
+            }
+            else{
+                data_ = allocator_.allocate(span_);
+                head_ = data_;
+                tail_ = head_+span_-1U;
+                // Construct...
+                try{
+                    detail::copy_n(allocator_, other.head_, span_, data_);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Move constructor (initialisation via constructor: dynarray() noexcept).
+        //! @note  Example: vla::dynarray<int, 2> a(std::move(b)) <=> vla::dynarray<int, 2> a = std::move(b).
+        //!
+        dynarray(dynarray&& other) noexcept : dynarray(){
+            swap(*this, other);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy/move assignment (calls copy/move constructor).
+        //! @note  Example: a = b.
+        //!                 a = std::move(b), where *this = a and other = b.
+        //!
+        dynarray& operator=(dynarray other) noexcept{
+            swap(*this, other);
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Expression assignment (single fused pass, no temporaries).
+        //! @note  Example: a = b+2.0*c.
+        //!                 a += b*c.
+        //!        The shapes of *this and the expression operands must match. See expression<E> (Expression.h).
+        //!
+        template<typename E>
+        dynarray& operator=(const expression<E>& e){
+            view() = e;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator+=(const X& x){
+            view() += x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator-=(const X& x){
+            view() -= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator*=(const X& x){
+            view() *= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator/=(const X& x){
+            view() /= x;
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
         //!
-        friend class dynarray<T, N+1U, A>;
+        //! @brief Destructor.
+        //!
+        ~dynarray() noexcept{
+            if(data_ != nullptr){
+                detail::destroy_n(allocator_, data_, span_);
+                allocator_.deallocate(data_, capacity_);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Template class (arrays of any rank, see reshape(Idx ...) &&).
+        //!
+        template<typename, size_t, template<typename> typename>
+        friend class dynarray;
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Element access: at.
         //!                        operator[].
+        //!                        operator().
         //!                        front.
         //!                        back.
         //!                        data.
+        //! @note  operator[] returns the (non-owning) view of array block i, e.g. a[i][j] for vla::dynarray<int, 3> a.
+        //!        Prefer operator()(i, j, k, ...) in hot loops: the offset is computed directly from the strides.
         //!
-        TYPE_R at(size_t i){
-            if(i >= size()){
+        TYPE_V at(size_t i){
+            if(i >= extents_[0U]){
                 throw std::out_of_range("dynarray<T, N, A>::at(size_t)");
             }
             return (*this)[i];
         }
-        const_TYPE_R at(size_t i) const{
-            if(i >= size()){
+        const_TYPE_V at(size_t i) const{
+            if(i >= extents_[0U]){
                 throw std::out_of_range("dynarray<T, N, A>::at(size_t) const");
             }
             return (*this)[i];
         }
-        TYPE_R operator[](size_t i) noexcept{
-            return *(DATA_+i);
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        type_r at(Idx ... idx){
+            if(!in_range(idx...)){
+                throw std::out_of_range("dynarray<T, N, A>::at(Idx ...)");
+            }
+            return (*this)(idx...);
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_type_r at(Idx ... idx) const{
+            if(!in_range(idx...)){
+                throw std::out_of_range("dynarray<T, N, A>::at(Idx ...) const");
+            }
+            return (*this)(idx...);
+        }
+        TYPE_V operator[](size_t i) noexcept{
+            return view().slice(0U, i);
+        }
+        const_TYPE_V operator[](size_t i) const noexcept{
+            return view().slice(0U, i);
         }
-        const_TYPE_R operator[](size_t i) const noexcept{
-            return *(DATA_+i);
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        type_r operator()(Idx ... idx) noexcept{
+            return *(head_+offset(idx...));
         }
-        TYPE_R front() noexcept{
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_type_r operator()(Idx ... idx) const noexcept{
+            return *(head_+offset(idx...));
+        }
+        TYPE_V front() noexcept{
             return (*this)[0U];
         }
-        const_TYPE_R front() const noexcept{
+        const_TYPE_V front() const noexcept{
             return (*this)[0U];
         }
-        TYPE_R back() noexcept{
-            return (*this)[SIZE_-1U];
+        TYPE_V back() noexcept{
+            return (*this)[extents_[0U]-1U];
         }
-        const_TYPE_R back() const noexcept{
-            return (*this)[SIZE_-1U];
+        const_TYPE_V back() const noexcept{
+            return (*this)[extents_[0U]-1U];
         }
-        TYPE_P data() noexcept{
+        type_p data() noexcept{
             return head_;
         }
-        const_TYPE_P data() const noexcept{
+        const_type_p data() const noexcept{
             return head_;
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Iterators: begin.
         //!                   end.
-        //!
+        //!                   indexed (elements together w/ their indices, see dynarray_view<T, N>::indexed).
+        //! @note  Example: std::transform(a.begin(), a.end(), b.begin(), f)       : flat (contiguous) pass over a.
+        //!                 std::reduce(std::execution::par_unseq, a.begin(), a.end()) : idem, w/ an execution policy.
+        //!                 for(auto [i, j, k, x] : a.indexed()){ ... }            : elements w/ their indices.
+        //!        Flat iterators are pointers (std::contiguous_iterator) over all n(0)*n(1)*... elements in row-major
+        //!        order. They are not available for padded arrays (see vla::padded_allocator), whose rows are not
+        //!        adjacent: iterate rows or indexed() instead.
+        //!
+        type_p begin() noexcept requires(detail::padding<type_a>() == 1U){
+            return head_;
+        }
+        const_type_p begin() const noexcept requires(detail::padding<type_a>() == 1U){
+            return head_;
+        }
+        type_p end() noexcept requires(detail::padding<type_a>() == 1U){
+            return head_+size_;
+        }
+        const_type_p end() const noexcept requires(detail::padding<type_a>() == 1U){
+            return head_+size_;
+        }
+        detail::indexed_range<T, N> indexed() noexcept{
+            return view().indexed();
+        }
+        detail::indexed_range<const T, N> indexed() const noexcept{
+            return view().indexed();
+        }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Capacity: empty.
         //!                  size.
         //!                  max_size.
+        //!                  extent.
+        //!                  extents.
+        //!                  stride.
+        //!                  leading_dimension.
+        //!                  is_contiguous.
+        //!                  capacity.
+        //! @note  leading_dimension() is the distance (elements) between consecutive rows, i.e. s(N-2) >= n(N-1). Rows
+        //!        are only padded if the allocator requests it (see vla::padded_allocator), in which case the array
+        //!        is not contiguous. capacity() is the number of elements (incl. padding) that fit in the allocated
+        //!        storage (see reserve).
         //!
-        bool empty() const{
+        bool empty() const noexcept{
             return size_ == 0U;
         }
-        size_t size() const{
-
-            std::cout << "X" << std::endl;
-
-            return static_cast<size_t>(head_-tail_+1U);
+        size_t size() const noexcept{
+            return size_;
         }
-        size_t max_size() const{
+        size_t max_size() const noexcept{
             return static_cast<size_t>(std::numeric_limits<size_d>::max());
         }
+        size_t extent(size_t k) const noexcept{
+            return extents_[k];
+        }
+        const TYPE_E& extents() const noexcept{
+            return extents_;
+        }
+        size_t stride(size_t k) const noexcept{
+            return strides_[k];
+        }
+        size_t leading_dimension() const noexcept{
+            return strides_[N-2U];
+        }
+        bool is_contiguous() const noexcept{
+            return span_ == size_;
+        }
+        size_t capacity() const noexcept{
+            return capacity_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory footprint: payload_bytes.
+        //!                          metadata_bytes.
+        //!                          allocation_count.
+        //! @note  payload_bytes() is the size of the allocated storage (incl. padding and spare capacity, see reserve),
+        //!        metadata_bytes() the size of the array object itself (extents, strides, pointers and allocator).
+        //!        allocation_count() is only available w/ a counting allocator (see vla::counting_allocator).
+        //!
+        size_t payload_bytes() const noexcept{
+            return capacity_*sizeof(T);
+        }
+        size_t metadata_bytes() const noexcept{
+            return sizeof(dynarray);
+        }
+        size_t allocation_count() const noexcept requires(requires(const type_a& a){a.allocation_count();}){
+            return allocator_.allocation_count();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Modifiers: reserve.
+        //!                   resize.
+        //!                   shrink_to_fit.
+        //! @note  Example: a.reserve(100U)    : storage for 100 outermost indices (n(1), n(2), ... are kept).
+        //!                 a.resize(120U)     : 120 outermost indices, new elements are value-initialised.
+        //!                 a.resize(120U, x)  : idem, new elements are copies of x.
+        //!        Only the outermost extent may change: existing elements keep their indices (and addresses, unless
+        //!        the capacity is exceeded). The capacity grows geometrically (x1.5), hence a sequence of small
+        //!        resizes reallocates O(log n) times. Trivially copyable elements are relocated w/ a single memcpy.
+        //!
+        void reserve(size_t n){
+            if(n*strides_[0U] > capacity_){
+                if(n*strides_[0U] >= max_size()){
+                    throw std::invalid_argument("dynarray<T, N, A>::reserve(size_t)");
+                }
+                reallocate(n*strides_[0U]);
+            }
+        }
+        template<typename ... Args>
+        void resize(size_t n, const Args& ... args){
+            const size_t m = size_from(1U);
+            const size_t s = strides_[0U];
+            if(n > extents_[0U]){
+                if(n*s > capacity_){
+                    if(n*s >= max_size()){
+                        throw std::invalid_argument("dynarray<T, N, A>::resize(size_t, const Args& ...)");
+                    }
+                    reallocate(std::max(n*s, capacity_+capacity_/2U));
+                }
+                detail::construct_n(allocator_, head_+span_, (n-extents_[0U])*s, args...);
+            }
+            else{
+                detail::destroy_n(allocator_, head_+n*s, span_-n*s);
+            }
+            // Initialise...
+            extents_[0U] = n;
+            size_        = n*m;
+            span_        = n*s;
+            tail_        = span_ == 0U ? nullptr : head_+span_-1U;
+        }
+        void shrink_to_fit(){
+            if(capacity_ > span_){
+                reallocate(span_);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Views: view.
+        //!               slice.
+        //!               subarray.
+        //!               transpose.
+        //!               reshape.
+        //! @note  None of these allocate nor copy: see dynarray_view<T, N>. On an rvalue, reshape returns an array
+        //!        that adopts the (contiguous) storage in O(1), e.g. auto b = std::move(a).reshape(n*m) (a is left
+        //!        empty).
+        //!
+        dynarray_view<T, N> view() noexcept{
+            return dynarray_view<T, N>(head_, extents_, strides_);
+        }
+        dynarray_view<const T, N> view() const noexcept{
+            return dynarray_view<const T, N>(head_, extents_, strides_);
+        }
+        TYPE_V slice(size_t k, size_t i) noexcept{
+            return view().slice(k, i);
+        }
+        const_TYPE_V slice(size_t k, size_t i) const noexcept{
+            return view().slice(k, i);
+        }
+        dynarray_view<T, N> slice(size_t k, size_t first, size_t n, size_t step = 1U){
+            return view().slice(k, first, n, step);
+        }
+        dynarray_view<const T, N> slice(size_t k, size_t first, size_t n, size_t step = 1U) const{
+            return view().slice(k, first, n, step);
+        }
+        dynarray_view<T, N> subarray(const TYPE_E& offsets, const TYPE_E& extents){
+            return view().subarray(offsets, extents);
+        }
+        dynarray_view<const T, N> subarray(const TYPE_E& offsets, const TYPE_E& extents) const{
+            return view().subarray(offsets, extents);
+        }
+        dynarray_view<T, N> transpose() noexcept{
+            return view().transpose();
+        }
+        dynarray_view<const T, N> transpose() const noexcept{
+            return view().transpose();
+        }
+        dynarray_view<T, N> transpose(size_t k, size_t l) noexcept{
+            return view().transpose(k, l);
+        }
+        dynarray_view<const T, N> transpose(size_t k, size_t l) const noexcept{
+            return view().transpose(k, l);
+        }
+        template<typename ... Idx>
+        dynarray_view<T, sizeof ... (Idx)> reshape(Idx ... n) &{
+            return view().reshape(n...);
+        }
+        template<typename ... Idx>
+        dynarray_view<const T, sizeof ... (Idx)> reshape(Idx ... n) const&{
+            return view().reshape(n...);
+        }
+        template<typename ... Idx>
+        dynarray<T, sizeof ... (Idx), A> reshape(Idx ... n) &&{
+            dynarray<T, sizeof ... (Idx), A> a;
+            if(span_ != size_ || !a.adopt(allocator_, data_, size_, capacity_, n...)){
+                throw std::invalid_argument("dynarray<T, N, A>::reshape(Idx ...) &&");
+            }
+            // Initialise...
+            size_     = 0U;
+            span_     = 0U;
+            capacity_ = 0U;
+            data_     = nullptr;
+            head_     = nullptr;
+            tail_     = nullptr;
+            extents_.fill(0U);
+            strides_.fill(0U);
+            return a;
+        }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Operations: fill.
         //!                    swap.
+        //!                    get_allocator.
         //!
+        void fill(const_type_v& value){
+            detail::fill_n(head_, span_, value);
+        }
+        friend void swap(dynarray& lhs, dynarray& rhs) noexcept{
+            std::swap(lhs.allocator_, rhs.allocator_);
+            std::swap(lhs.data_, rhs.data_);
+            std::swap(lhs.head_, rhs.head_);
+            std::swap(lhs.tail_, rhs.tail_);
+            std::swap(lhs.size_, rhs.size_);
+            std::swap(lhs.span_, rhs.span_);
+            std::swap(lhs.capacity_, rhs.capacity_);
+            std::swap(lhs.extents_, rhs.extents_);
+            std::swap(lhs.strides_, rhs.strides_);
+        }
+        type_a get_allocator() const noexcept{
+            return allocator_;
+        }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Non-member functions: operator<< .
@@ -223,33 +655,105 @@ namespace vla{
         //!
         //--------------------------------------------------------------------------------------------------------------
         //!
-        //! @brief
+        //! @brief Initialise extents, strides and size from the first N (input) arguments.
         //!
+        template<typename Tuple, size_t ... I>
+        void init(const Tuple& args, std::index_sequence<I ...>) noexcept{
+            constexpr size_t p = detail::padding<type_a>();
+
+            extents_ = {detail::index(std::get<I>(args)) ...};
+            size_    = 1U;
+            span_    = 1U;
+            for(size_t k = N; k > 0U; --k){
+                strides_[k-1U] = span_;
+                size_         *= extents_[k-1U];
+                span_         *= k == N ? (extents_[k-1U]+p-1U)/p*p : extents_[k-1U];
+            }
+            capacity_ = span_;
+        }
         //--------------------------------------------------------------------------------------------------------------
-        template<typename ... Args>
-        static size_t get(size_t n, Args&& ... args){
-            return TYPE_V::get(std::forward<Args>(args)...)*n;
+        //!
+        //! @brief Construct each element w/ the (input) arguments following the extents.
+        //!
+        template<typename Tuple, size_t ... I>
+        void construct(const Tuple& args, std::index_sequence<I ...>){
+            detail::construct_n(allocator_, data_, span_, std::get<N+I>(args)...);
+        }
+        template<typename Initializer, typename Tuple, size_t ... I>
+        void construct(const Initializer& initializer, const Tuple& args, std::index_sequence<I ...>){
+            initializer(allocator_, data_, extents_, strides_[0U], std::get<N+I>(args)...);
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
-        //! @brief
+        //! @brief Number of elements of n outermost indices (n*n(1)*n(2)*...).
         //!
-        template<typename ... Args>
-        void set(type_p p, size_t n, Args&& ... args){
-            // Get size of array block.
-            size_t bsize = TYPE_V::get(std::forward<Args>(args)...);
-
+        size_t size_from(size_t n) const noexcept{
+            for(size_t k = 1U; k < N; ++k){
+                n *= extents_[k];
+            }
+            return n;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Move the (constructed) elements to new storage of capacity elements.
+        //!
+        void reallocate(size_t capacity){
+            type_p data = capacity == 0U ? nullptr : allocator_.allocate(capacity);
+            if(data_ != nullptr){
+                try{
+                    if(span_ != 0U){
+                        detail::relocate_n(allocator_, data_, span_, data);
+                    }
+                }
+                catch(...){
+                    allocator_.deallocate(data, capacity);
+                    throw;
+                }
+                allocator_.deallocate(data_, capacity_);
+            }
             // Initialise...
-            data_ = nullptr;
-            head_ = p;
-            tail_ = head_+n*bsize-1U;
-            DATA_ = ALLOCATOR_.allocate(n);
-            // Construct...
-            for(size_t i = 0U; i < n; ++i){
-                std::allocator_traits<TYPE_A>::construct(ALLOCATOR_, p+i);
-                (DATA_+i)->allocator_ = allocator_;
-                (DATA_+i)->set(p+i*bsize, std::forward<Args>(args)...);
+            capacity_ = capacity;
+            data_     = data;
+            head_     = data_;
+            tail_     = span_ == 0U ? nullptr : head_+span_-1U;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Adopt the (contiguous) storage of another array w/ extents n(0), n(1), ... (false if n(0)*n(1)*... is
+        //!        not size or the storage would have to be padded).
+        //!
+        template<typename ... Idx>
+        bool adopt(type_a& allocator, type_p data, size_t size, size_t capacity, Idx ... n){
+            init(std::forward_as_tuple(n...), std::make_index_sequence<N>{});
+            if(size_ != size || span_ != size_){
+                return false;
             }
+            // Initialise...
+            allocator_ = std::move(allocator);
+            capacity_  = capacity;
+            data_      = data;
+            head_      = data_;
+            tail_      = span_ == 0U ? nullptr : head_+span_-1U;
+            return true;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Offset of element (i(0), i(1), ...) w.r.t. head.
+        //!
+        template<typename ... Idx>
+        size_t offset(Idx ... idx) const noexcept{
+            size_t k = 0U, o = 0U;
+            ((o += detail::index(idx)*strides_[k++]), ...);
+            return o;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether element (i(0), i(1), ...) is within bounds.
+        //!
+        template<typename ... Idx>
+        bool in_range(Idx ... idx) const noexcept{
+            size_t k = 0U;
+            return ((detail::index(idx) < extents_[k++]) && ...);
         }
         //--------------------------------------------------------------------------------------------------------------
     };
@@ -276,6 +780,7 @@ namespace vla{
         //! @brief Member variables.
         //!
         size_t size_;      //!<Type              size.
+        size_t capacity_;  //!<Type              capacity.       //!<>= size_.
         type_a allocator_; //!<Type              allocator.
         type_p data_;      //!<Type (pointer to) data (content).
         type_p head_;      //!<Type (pointer to) head.
@@ -294,10 +799,11 @@ namespace vla{
         //!
         explicit dynarray() noexcept{
             // Initialise...
-            size_ = 0U;
-            data_ = nullptr;
-            head_ = nullptr;
-            tail_ = nullptr;
+            size_     = 0U;
+            capacity_ = 0U;
+            data_     = nullptr;
+            head_     = nullptr;
+            tail_     = nullptr;
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
@@ -312,26 +818,135 @@ namespace vla{
         explicit dynarray(size_t n, Args&& ... args){
             if(n == 0U){
                 // Initialise...
-                size_ = 0U;
-                data_ = nullptr;
-                head_ = nullptr;
-                tail_ = nullptr;
+                size_     = 0U;
+                capacity_ = 0U;
+                data_     = nullptr;
+                head_     = nullptr;
+                tail_     = nullptr;
             }
             else{
                 if(n >= max_size()){
                     throw std::invalid_argument("dynarray<T, 1, A>::dynarray(size_t, Args&& ...)");
                 }
                 // Initialise...
-                size_ = n;
-                data_ = allocator_.allocate(size_);
-                head_ = data_;
-                tail_ = head_+size_-1U;
+                size_     = n;
+                capacity_ = size_;
+                data_     = allocator_.allocate(size_);
+                head_     = data_;
+                tail_     = head_+size_-1U;
                 // Construct...
-                for(size_t i = 0U; i < size_; ++i){
-                    std::allocator_traits<type_a>::construct(allocator_, data_+i, std::forward<Args>(args)...);
+                try{
+                    detail::construct_n(allocator_, data_, size_, args...);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
                 }
             }
         }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (uninitialised/default-initialised elements).
+        //! @note  Example: vla::dynarray<double> a(vla::uninitialized, 5U) : no element is written.
+        //!                 vla::dynarray<double> a(vla::default_init,  5U) : idem (T is trivial).
+        //!
+        explicit dynarray(uninitialized_t, size_t n) : dynarray(default_init, n){
+            static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                          "dynarray<T, 1, A>::dynarray(uninitialized_t, size_t): T must be trivial.");
+        }
+        explicit dynarray(default_init_t, size_t n){
+            if(n == 0U){
+                // Initialise...
+                size_     = 0U;
+                capacity_ = 0U;
+                data_     = nullptr;
+                head_     = nullptr;
+                tail_     = nullptr;
+            }
+            else{
+                if(n >= max_size()){
+                    throw std::invalid_argument("dynarray<T, 1, A>::dynarray(default_init_t, size_t)");
+                }
+                // Initialise...
+                size_     = n;
+                capacity_ = size_;
+                data_     = allocator_.allocate(size_);
+                head_     = data_;
+                tail_     = head_+size_-1U;
+                // Construct...
+                try{
+                    detail::default_init_n(allocator_, data_, size_);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (custom element initialiser).
+        //! @note  Example: vla::dynarray<double> a(vla::parallel::first_touch, 5U, 1.0) : see Parallel.h.
+        //!
+        template<typename I, typename ... Args> requires(detail::is_initializer_v<I>)
+        explicit dynarray(const I& initializer, size_t n, Args&& ... args){
+            if(n == 0U){
+                // Initialise...
+                size_     = 0U;
+                capacity_ = 0U;
+                data_     = nullptr;
+                head_     = nullptr;
+                tail_     = nullptr;
+            }
+            else{
+                if(n >= max_size()){
+                    throw std::invalid_argument("dynarray<T, 1, A>::dynarray(const I&, size_t, Args&& ...)");
+                }
+                // Initialise...
+                size_     = n;
+                capacity_ = size_;
+                data_     = allocator_.allocate(size_);
+                head_     = data_;
+                tail_     = head_+size_-1U;
+                // Construct...
+                try{
+                    initializer(allocator_, data_, std::array<size_t, 1U>{size_}, 1U, args...);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Factory (storage mapped by the allocator, e.g. a file; elements are not initialised).
+        //! @note  Example: auto a = vla::dynarray<double, 1, vla::mapped_allocator>::map("u.bin", read_only, 5U)
+        //!
+        static dynarray map(const type_a& allocator, size_t n){
+            static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                          "dynarray<T, 1, A>::map(const type_a&, size_t): T must be trivially copyable.");
+            dynarray a;
+            a.allocator_ = allocator;
+            if(n != 0U){
+                if(n >= a.max_size()){
+                    throw std::invalid_argument("dynarray<T, 1, A>::map(const type_a&, size_t)");
+                }
+                // Initialise...
+                a.size_     = n;
+                a.capacity_ = a.size_;
+                a.data_     = a.allocator_.allocate(a.size_);
+                a.head_     = a.data_;
+                a.tail_     = a.head_+a.size_-1U;
+            }
+            return a;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        static dynarray map(const std::filesystem::path& path, map_mode mode, size_t n)
+            requires(std::is_constructible_v<type_a, const std::filesystem::path&, map_mode>){
+            return map(type_a(path, mode), n);
+        }
+#endif
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Constructor.
@@ -341,23 +956,29 @@ namespace vla{
         explicit dynarray(std::initializer_list<T> il){
             if(il.size() == 0U){
                 // Initialise...
-                size_ = 0U;
-                data_ = nullptr;
-                head_ = nullptr;
-                tail_ = nullptr;
+                size_     = 0U;
+                capacity_ = 0U;
+                data_     = nullptr;
+                head_     = nullptr;
+                tail_     = nullptr;
             }
             else{
                 if(il.size() >= max_size()){
                     throw std::invalid_argument("dynarray<T, 1, A>::dynarray(std::initializer_list<T>)");
                 }
                 // Initialise...
-                size_ = il.size();
-                data_ = allocator_.allocate(size_);
-                head_ = data_;
-                tail_ = head_+size_-1U;
+                size_     = il.size();
+                capacity_ = size_;
+                data_     = allocator_.allocate(size_);
+                head_     = data_;
+                tail_     = head_+size_-1U;
                 // Construct...
-                for(size_t i = 0U; i < size_; ++i){
-                    std::allocator_traits<type_a>::construct(allocator_, data_+i, *(il.begin()+i));
+                try{
+                    detail::copy_n(allocator_, il.begin(), size_, data_);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
                 }
             }
         }
@@ -368,23 +989,30 @@ namespace vla{
         //!                 vla::dynarray<int, 1U> a(b) <=> vla::dynarray<int, 1U> a = b.
         //! @see   https://www.geeksforgeeks.org/shallow-copy-and-deep-copy-in-c/
         //!
-        dynarray(const dynarray& other) noexcept{
+        dynarray(const dynarray& other) :
+            allocator_(std::allocator_traits<type_a>::select_on_container_copy_construction(other.allocator_)){
             if(other.size() == 0U){
                 // Initialise...
-                size_ = 0U;
-                data_ = nullptr;
-                head_ = nullptr;
-                tail_ = nullptr;
+                size_     = 0U;
+                capacity_ = 0U;
+                data_     = nullptr;
+                head_     = nullptr;
+                tail_     = nullptr;
             }
             else{
                 // Initialise...
-                size_ = other.size();
-                data_ = allocator_.allocate(size_);
-                head_ = data_;
-                tail_ = head_+size_-1U;
+                size_     = other.size();
+                capacity_ = size_;
+                data_     = allocator_.allocate(size_);
+                head_     = data_;
+                tail_     = head_+size_-1U;
                 // Construct...
-                for(size_t i = 0U; i < size_; ++i){
-                    std::allocator_traits<type_a>::construct(allocator_, data_+i, *(other.data_+i));
+                try{
+                    detail::copy_n(allocator_, other.head_, size_, data_);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, capacity_);
+                    throw;
                 }
             }
         }
@@ -411,6 +1039,38 @@ namespace vla{
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
+        //! @brief Expression assignment (single fused pass, no temporaries).
+        //! @note  Example: a = b+2.0*c.
+        //!                 a += b*c.
+        //!        The shapes of *this and the expression operands must match. See expression<E> (Expression.h).
+        //!
+        template<typename E>
+        dynarray& operator=(const expression<E>& e){
+            view() = e;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator+=(const X& x){
+            view() += x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator-=(const X& x){
+            view() -= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator*=(const X& x){
+            view() *= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<dynarray, X>)
+        dynarray& operator/=(const X& x){
+            view() /= x;
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
         //! @brief Destructor.
         //! @note  Deleting a null pointer effectively amounts to a no-operation.
         //! @see   https://stackoverflow.com/questions/615355/is-there-any-reason-to-check-for-a-null-pointer-before-deleting
@@ -418,17 +1078,16 @@ namespace vla{
         //!
         ~dynarray() noexcept{
             if(data_ != nullptr){
-                for(size_t i = size_; i > 0U; --i){
-                    std::allocator_traits<type_a>::destroy(allocator_, data_+i-1U);
-                }
-                allocator_.deallocate(data_, size_);
+                detail::destroy_n(allocator_, data_, size_);
+                allocator_.deallocate(data_, capacity_);
             }
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Template class.
         //!
-        friend class dynarray<T, 2U, A>;
+        template<typename, size_t, template<typename> typename>
+        friend class dynarray;
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Element access: at.
@@ -455,6 +1114,12 @@ namespace vla{
         const_type_r operator[](size_t i) const noexcept{
             return *(head_+i);
         }
+        type_r operator()(size_t i) noexcept{
+            return *(head_+i);
+        }
+        const_type_r operator()(size_t i) const noexcept{
+            return *(head_+i);
+        }
         type_r front() noexcept{
             return (*this)[0U];
         }
@@ -477,6 +1142,7 @@ namespace vla{
         //!
         //! @brief Iterators: begin.
         //!                   end.
+        //!                   indexed (elements together w/ their indices, see dynarray_view<T, N>::indexed).
         //!
         type_p begin() noexcept{
             return head_;
@@ -485,41 +1151,183 @@ namespace vla{
             return head_;
         }
         type_p end() noexcept{
-            return tail_+1U;
+            return head_+size_;
         }
         const_type_p end() const noexcept{
-            return tail_+1U;
+            return head_+size_;
+        }
+        detail::indexed_range<T, 1U> indexed() noexcept{
+            return view().indexed();
+        }
+        detail::indexed_range<const T, 1U> indexed() const noexcept{
+            return view().indexed();
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Capacity: empty.
         //!                  size.
         //!                  max_size.
+        //!                  extent.
+        //!                  extents.
+        //!                  stride.
+        //!                  leading_dimension.
+        //!                  is_contiguous.
+        //!                  capacity.
         //!
         bool empty() const noexcept{
             return size() == 0U;
         }
         size_t size() const noexcept{
-            return static_cast<size_t>(tail_-head_+1U);
+            return size_;
         }
         size_t max_size() const noexcept{
             return static_cast<size_t>(std::numeric_limits<size_d>::max());
         }
+        size_t extent(size_t) const noexcept{
+            return size_;
+        }
+        std::array<size_t, 1U> extents() const noexcept{
+            return {size_};
+        }
+        size_t stride(size_t) const noexcept{
+            return 1U;
+        }
+        size_t leading_dimension() const noexcept{
+            return size_;
+        }
+        bool is_contiguous() const noexcept{
+            return true;
+        }
+        size_t capacity() const noexcept{
+            return capacity_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory footprint: payload_bytes.
+        //!                          metadata_bytes.
+        //!                          allocation_count.
+        //! @note  payload_bytes() is the size of the allocated storage (incl. spare capacity, see reserve),
+        //!        metadata_bytes() the size of the array object itself (pointers, sizes and allocator).
+        //!        allocation_count() is only available w/ a counting allocator (see vla::counting_allocator).
+        //!
+        size_t payload_bytes() const noexcept{
+            return capacity_*sizeof(T);
+        }
+        size_t metadata_bytes() const noexcept{
+            return sizeof(dynarray);
+        }
+        size_t allocation_count() const noexcept requires(requires(const type_a& a){a.allocation_count();}){
+            return allocator_.allocation_count();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Modifiers: reserve.
+        //!                   resize.
+        //!                   shrink_to_fit.
+        //! @note  Example: a.reserve(100U)   : storage for 100 elements.
+        //!                 a.resize(120U)    : 120 elements, new elements are value-initialised.
+        //!                 a.resize(120U, x) : idem, new elements are copies of x.
+        //!        The capacity grows geometrically (x1.5). Trivially copyable elements are relocated w/ a single memcpy.
+        //!
+        void reserve(size_t n){
+            if(n > capacity_){
+                if(n >= max_size()){
+                    throw std::invalid_argument("dynarray<T, 1, A>::reserve(size_t)");
+                }
+                reallocate(n);
+            }
+        }
+        template<typename ... Args>
+        void resize(size_t n, const Args& ... args){
+            if(n > size_){
+                if(n > capacity_){
+                    if(n >= max_size()){
+                        throw std::invalid_argument("dynarray<T, 1, A>::resize(size_t, const Args& ...)");
+                    }
+                    reallocate(std::max(n, capacity_+capacity_/2U));
+                }
+                detail::construct_n(allocator_, head_+size_, n-size_, args...);
+            }
+            else{
+                detail::destroy_n(allocator_, head_+n, size_-n);
+            }
+            // Initialise...
+            size_ = n;
+            tail_ = size_ == 0U ? nullptr : head_+size_-1U;
+        }
+        void shrink_to_fit(){
+            if(capacity_ > size_){
+                reallocate(size_);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Views: view.
+        //!               slice.
+        //!               subarray.
+        //!               reshape.
+        //! @note  None of these allocate nor copy: see dynarray_view<T, N>. On an rvalue, reshape returns an array
+        //!        that adopts the storage in O(1), e.g. auto b = std::move(a).reshape(n, m) (a is left empty).
+        //!
+        dynarray_view<T> view() noexcept{
+            return dynarray_view<T>(head_, {size_});
+        }
+        dynarray_view<const T> view() const noexcept{
+            return dynarray_view<const T>(head_, {size_});
+        }
+        dynarray_view<T> slice(size_t first, size_t n, size_t step = 1U){
+            return view().slice(0U, first, n, step);
+        }
+        dynarray_view<const T> slice(size_t first, size_t n, size_t step = 1U) const{
+            return view().slice(0U, first, n, step);
+        }
+        dynarray_view<T> subarray(size_t offset, size_t n){
+            return view().subarray({offset}, {n});
+        }
+        dynarray_view<const T> subarray(size_t offset, size_t n) const{
+            return view().subarray({offset}, {n});
+        }
+        template<typename ... Idx>
+        dynarray_view<T, sizeof ... (Idx)> reshape(Idx ... n) &{
+            return view().reshape(n...);
+        }
+        template<typename ... Idx>
+        dynarray_view<const T, sizeof ... (Idx)> reshape(Idx ... n) const&{
+            return view().reshape(n...);
+        }
+        template<typename ... Idx>
+        dynarray<T, sizeof ... (Idx), A> reshape(Idx ... n) &&{
+            dynarray<T, sizeof ... (Idx), A> a;
+            if(!a.adopt(allocator_, data_, size_, capacity_, n...)){
+                throw std::invalid_argument("dynarray<T, 1, A>::reshape(Idx ...) &&");
+            }
+            // Initialise...
+            size_     = 0U;
+            capacity_ = 0U;
+            data_     = nullptr;
+            head_     = nullptr;
+            tail_     = nullptr;
+            return a;
+        }
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Operations: fill.
         //!                    swap.
+        //!                    get_allocator.
         //!
         void fill(const_type_v& value) noexcept{
-            for(size_t i = 0U; i < size(); ++i){
-                (*this)[i] = value;
-            }
+            detail::fill_n(head_, size_, value);
         }
         friend void swap(dynarray& lhs, dynarray& rhs) noexcept{
+            std::swap(lhs.allocator_, rhs.allocator_);
             std::swap(lhs.data_, rhs.data_);
             std::swap(lhs.head_, rhs.head_);
             std::swap(lhs.tail_, rhs.tail_);
             std::swap(lhs.size_, rhs.size_);
+            std::swap(lhs.capacity_, rhs.capacity_);
+        }
+        type_a get_allocator() const noexcept{
+            return allocator_;
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
@@ -550,31 +1358,48 @@ namespace vla{
         //--------------------------------------------------------------------------------------------------------------
         //!
         //! @brief Auxiliary functions.
-        //! @see   https://stackoverflow.com/questions/10442404/invoke-a-c-class-method-without-a-class-instance
         //!
         //--------------------------------------------------------------------------------------------------------------
         //!
-        //! @brief
+        //! @brief Move the (constructed) elements to new storage of capacity elements.
         //!
-        //--------------------------------------------------------------------------------------------------------------
-        template<typename ... Args>
-        static size_t get(size_t n, Args&& ...){
-            return n;
+        void reallocate(size_t capacity){
+            type_p data = capacity == 0U ? nullptr : allocator_.allocate(capacity);
+            if(data_ != nullptr){
+                try{
+                    if(size_ != 0U){
+                        detail::relocate_n(allocator_, data_, size_, data);
+                    }
+                }
+                catch(...){
+                    allocator_.deallocate(data, capacity);
+                    throw;
+                }
+                allocator_.deallocate(data_, capacity_);
+            }
+            // Initialise...
+            capacity_ = capacity;
+            data_     = data;
+            head_     = data_;
+            tail_     = size_ == 0U ? nullptr : head_+size_-1U;
         }
         //--------------------------------------------------------------------------------------------------------------
         //!
-        //! @brief
+        //! @brief Adopt the storage of another array w/ extent n (false if n is not size).
         //!
-        template<typename ... Args>
-        void set(type_p p, size_t n, Args&& ... args){
-            // Initialise...
-            data_ = nullptr;
-            head_ = p;
-            tail_ = head_+n-1U;
-            // Construct...
-            for(size_t i = 0U; i < n; ++i){
-                std::allocator_traits<type_a>::construct(allocator_, p+i, std::forward<Args>(args)...);
+        template<typename I>
+        bool adopt(type_a& allocator, type_p data, size_t size, size_t capacity, I n){
+            if(detail::index(n) != size){
+                return false;
             }
+            // Initialise...
+            allocator_ = std::move(allocator);
+            size_      = size;
+            capacity_  = capacity;
+            data_      = data;
+            head_      = data_;
+            tail_      = size_ == 0U ? nullptr : head_+size_-1U;
+            return true;
         }
         //--------------------------------------------------------------------------------------------------------------
     };
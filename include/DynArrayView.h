@@ -0,0 +1,472 @@
+/**
+ * @file    DynArrayView.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Non-owning (strided) view over dynamic array storage.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_DYNARRAYVIEW_H
+#define DYNARRAY_DYNARRAYVIEW_H
+
+#include<array>
+#include<concepts>
+#include<iterator>
+#include<stdexcept>
+#include<tuple>
+#include<utility>
+
+#include "Auxiliary.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Forward declarations.
+    //!
+    template<typename T, size_t N>
+    class dynarray_view;
+    template<typename E>
+    class expression;
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether type is a view.
+        //!
+        template<typename V>
+        struct is_view : std::false_type{
+        };
+        template<typename T, size_t N>
+        struct is_view<dynarray_view<T, N>> : std::true_type{
+        };
+        template<typename V>
+        inline constexpr bool is_view_v = is_view<std::remove_cvref_t<V>>::value;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Multi-index range (see dynarray_view<T, N>::indexed).
+        //!
+        template<typename T, size_t N>
+        class indexed_range;
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief N-D (non-owning) array view template.
+    //! @note  A view is a pointer plus extents plus strides: it never allocates nor copies and it is trivially copyable,
+    //!        hence it should be passed by value. Constness is shallow (as for std::span): use dynarray_view<const T, N>
+    //!        for read-only access.
+    //!
+    template<typename T, size_t N = 1U>
+    class dynarray_view{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using       type_v =       T;                     //!<         Type value      alias.
+        using       type_p =       type_v*;               //!<         Type pointer    alias.
+        using       type_r =       type_v&;               //!<         Type reference  alias.
+        using       TYPE_E =       std::array<size_t, N>; //!<         Type extents    alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        type_p head_;    //!<Type (pointer to) head.
+        TYPE_E extents_; //!<Type              extents. //!<n(0), n(1), n(2), ...
+        TYPE_E strides_; //!<Type              strides. //!<s(0), s(1), s(2), ...
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Implicitly-defined member functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        constexpr dynarray_view() noexcept : head_(nullptr), extents_{}, strides_{}{
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::dynarray_view<int, 2> v(p, {2U, 3U})          : 2x3 (row-major) view of p.
+        //!                 vla::dynarray_view<int, 2> v(p, {2U, 3U}, {1U, 2U}) : 2x3 (column-major) view of p.
+        //!
+        constexpr dynarray_view(type_p p, const TYPE_E& extents) noexcept : head_(p), extents_(extents), strides_{}{
+            size_t s = 1U;
+            for(size_t k = N; k > 0U; --k){
+                strides_[k-1U] = s;
+                s             *= extents_[k-1U];
+            }
+        }
+        constexpr dynarray_view(type_p p, const TYPE_E& extents, const TYPE_E& strides) noexcept : head_(p),
+                                                                                                  extents_(extents),
+                                                                                                  strides_(strides){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (from any N-D array exposing data(), extents() and stride(k), e.g. vla::dynarray<T, N>).
+        //! @note  Example: void kernel(vla::dynarray_view<const double, 3> v)
+        //!                 kernel(a), where a is a vla::dynarray<double, 3>.
+        //!
+        template<typename C> requires(!detail::is_view_v<C> && requires(C& c){
+            {c.data()} -> std::convertible_to<type_p>;
+            {c.stride(0U)} -> std::convertible_to<size_t>;
+            requires std::tuple_size_v<std::remove_cvref_t<decltype(c.extents())>> == N;
+        })
+        constexpr dynarray_view(C& c) noexcept : head_(c.data()), extents_(c.extents()), strides_{}{
+            for(size_t k = 0U; k < N; ++k){
+                strides_[k] = c.stride(k);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (conversion: dynarray_view<T, N> -> dynarray_view<const T, N>).
+        //!
+        template<typename U> requires(!std::is_same_v<U, T> && std::is_convertible_v<U(*)[], T(*)[]>)
+        constexpr dynarray_view(const dynarray_view<U, N>& other) noexcept : head_(other.data()),
+                                                                             extents_(other.extents()),
+                                                                             strides_(other.strides()){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Expression assignment: operator= .
+        //!                               operator+=.
+        //!                               operator-=.
+        //!                               operator*=.
+        //!                               operator/=.
+        //! @note  Example: a.slice(2U, 0U) = b.slice(2U, 1U)+c.slice(2U, 1U) : elements of the view are written.
+        //!        Copy assignment (view = view) rebinds the view, i.e. it does not copy elements (use v = +w instead).
+        //!        See expression<E> (Expression.h).
+        //!
+        template<typename E>
+        const dynarray_view& operator=(const expression<E>& e) const{
+            e.evaluate(*this);
+            return *this;
+        }
+        template<typename X>
+        const dynarray_view& operator+=(const X& x) const{
+            return *this = *this+x;
+        }
+        template<typename X>
+        const dynarray_view& operator-=(const X& x) const{
+            return *this = *this-x;
+        }
+        template<typename X>
+        const dynarray_view& operator*=(const X& x) const{
+            return *this = *this*x;
+        }
+        template<typename X>
+        const dynarray_view& operator/=(const X& x) const{
+            return *this = *this/x;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: at.
+        //!                        operator[].
+        //!                        operator().
+        //!                        front.
+        //!                        back.
+        //!                        data.
+        //! @note  operator[] returns the (N-1)-D view of block i (N > 1) or a reference to element i (N = 1).
+        //!
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        constexpr type_r at(Idx ... idx) const{
+            size_t k = 0U;
+            if(!((detail::index(idx) < extents_[k++]) && ...)){
+                throw std::out_of_range("dynarray_view<T, N>::at(Idx ...)");
+            }
+            return (*this)(idx...);
+        }
+        constexpr decltype(auto) operator[](size_t i) const noexcept{
+            if constexpr(N == 1U){
+                return *(head_+i*strides_[0U]);
+            }
+            else{
+                return slice(0U, i);
+            }
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        constexpr type_r operator()(Idx ... idx) const noexcept{
+            size_t k = 0U, o = 0U;
+            ((o += detail::index(idx)*strides_[k++]), ...);
+            return *(head_+o);
+        }
+        constexpr type_r operator()(const TYPE_E& idx) const noexcept{
+            size_t o = 0U;
+            for(size_t k = 0U; k < N; ++k){
+                o += idx[k]*strides_[k];
+            }
+            return *(head_+o);
+        }
+        constexpr decltype(auto) front() const noexcept{
+            return (*this)[0U];
+        }
+        constexpr decltype(auto) back() const noexcept{
+            return (*this)[extents_[0U]-1U];
+        }
+        constexpr type_p data() const noexcept{
+            return head_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: empty.
+        //!                  size.
+        //!                  extent.
+        //!                  extents.
+        //!                  stride.
+        //!                  strides.
+        //!                  is_contiguous.
+        //!
+        constexpr bool empty() const noexcept{
+            return size() == 0U;
+        }
+        constexpr size_t size() const noexcept{
+            size_t n = 1U;
+            for(size_t k = 0U; k < N; ++k){
+                n *= extents_[k];
+            }
+            return n;
+        }
+        constexpr size_t extent(size_t k) const noexcept{
+            return extents_[k];
+        }
+        constexpr const TYPE_E& extents() const noexcept{
+            return extents_;
+        }
+        constexpr size_t stride(size_t k) const noexcept{
+            return strides_[k];
+        }
+        constexpr const TYPE_E& strides() const noexcept{
+            return strides_;
+        }
+        constexpr bool is_contiguous() const noexcept{
+            size_t s = 1U;
+            for(size_t k = N; k > 0U; --k){
+                if(extents_[k-1U] != 1U && strides_[k-1U] != s){
+                    return false;
+                }
+                s *= extents_[k-1U];
+            }
+            return true;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Iterators: indexed (elements together w/ their indices, in row-major order).
+        //! @note  Example: for(auto [i, j, k, x] : v.indexed()){ x = f(i, j, k); }
+        //!        Each element is yielded as a std::tuple<size_t, ..., T&> (N indices, then the element).
+        //!
+        constexpr detail::indexed_range<T, N> indexed() const noexcept{
+            return detail::indexed_range<T, N>(*this);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Views: slice.
+        //!               subarray.
+        //!               transpose.
+        //!               reshape.
+        //! @note  Example: v.slice(2U, 0U)                  : (N-1)-D face k = 0 of a 3-D view (i, j, k).
+        //!                 v.slice(0U, 1U, 4U, 2U)          : N-D view of rows 1, 3, 5, 7.
+        //!                 v.subarray({1U, 1U}, {8U, 8U})   : N-D 8x8 interior block of a 10x10 view.
+        //!                 v.transpose()                    : N-D view w/ reversed dimensions.
+        //!                 v.transpose(0U, 2U)              : N-D view w/ dimensions 0 and 2 swapped.
+        //!                 v.reshape(6U, 4U)                : M-D view of a contiguous 2x3x4 view.
+        //!
+        constexpr dynarray_view<T, N-1U> slice(size_t k, size_t i) const noexcept requires(N > 1U){
+            std::array<size_t, N-1U> e{}, s{};
+            for(size_t l = 0U, m = 0U; l < N; ++l){
+                if(l != k){
+                    e[m] = extents_[l];
+                    s[m] = strides_[l];
+                    ++m;
+                }
+            }
+            return dynarray_view<T, N-1U>(head_+i*strides_[k], e, s);
+        }
+        constexpr dynarray_view slice(size_t k, size_t first, size_t n, size_t step = 1U) const{
+            if(step == 0U || (n > 0U && first+(n-1U)*step >= extents_[k])){
+                throw std::out_of_range("dynarray_view<T, N>::slice(size_t, size_t, size_t, size_t)");
+            }
+            dynarray_view v(*this);
+            v.head_        += first*strides_[k];
+            v.extents_[k]   = n;
+            v.strides_[k]  *= step;
+            return v;
+        }
+        constexpr dynarray_view subarray(const TYPE_E& offsets, const TYPE_E& extents) const{
+            dynarray_view v(*this);
+            for(size_t k = 0U; k < N; ++k){
+                if(offsets[k]+extents[k] > extents_[k]){
+                    throw std::out_of_range("dynarray_view<T, N>::subarray(const TYPE_E&, const TYPE_E&)");
+                }
+                v.head_      += offsets[k]*strides_[k];
+                v.extents_[k] = extents[k];
+            }
+            return v;
+        }
+        constexpr dynarray_view transpose() const noexcept{
+            dynarray_view v(*this);
+            for(size_t k = 0U; k < N; ++k){
+                v.extents_[k] = extents_[N-1U-k];
+                v.strides_[k] = strides_[N-1U-k];
+            }
+            return v;
+        }
+        constexpr dynarray_view transpose(size_t k, size_t l) const noexcept{
+            dynarray_view v(*this);
+            std::swap(v.extents_[k], v.extents_[l]);
+            std::swap(v.strides_[k], v.strides_[l]);
+            return v;
+        }
+        template<typename ... Idx>
+        constexpr dynarray_view<T, sizeof ... (Idx)> reshape(Idx ... n) const{
+            const std::array<size_t, sizeof ... (Idx)> e{detail::index(n)...};
+            size_t m = 1U;
+            for(size_t k = 0U; k < e.size(); ++k){
+                m *= e[k];
+            }
+            if(m != size() || !is_contiguous()){
+                throw std::invalid_argument("dynarray_view<T, N>::reshape(Idx ...)");
+            }
+            return dynarray_view<T, sizeof ... (Idx)>(head_, e);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Multi-index (forward) iterator over the elements of a view, in row-major order.
+        //!
+        template<size_t>
+        using index_t = size_t;
+        template<typename T, size_t N, typename S = std::make_index_sequence<N>>
+        class indexed_iterator;
+        template<typename T, size_t N, size_t ... K>
+        class indexed_iterator<T, N, std::index_sequence<K ...>>{
+        private:
+            dynarray_view<T, N>   view_;   //!<View.
+            std::array<size_t, N> index_;  //!<Index   (i(0), i(1), ...).
+            size_t                offset_; //!<Offset  of element i w.r.t. the view's head.
+            size_t                count_;  //!<Ordinal of element i (row-major).
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type   = size_d;
+            using value_type        = std::tuple<index_t<K> ..., std::remove_const_t<T>>;
+            using reference         = std::tuple<index_t<K> ..., T&>;
+            //----------------------------------------------------------------------------------------------------------
+            constexpr indexed_iterator() noexcept : view_(), index_{}, offset_(0U), count_(0U){
+            }
+            constexpr indexed_iterator(const dynarray_view<T, N>& view, size_t count) noexcept : view_(view), index_{},
+                                                                                               offset_(0U),
+                                                                                               count_(count){
+            }
+            constexpr reference operator*() const noexcept{
+                return reference(index_[K] ..., view_.data()[offset_]);
+            }
+            constexpr indexed_iterator& operator++() noexcept{
+                ++count_;
+                for(size_t k = N; k > 0U; --k){
+                    offset_ += view_.stride(k-1U);
+                    if(++index_[k-1U] < view_.extent(k-1U)){
+                        break;
+                    }
+                    offset_         -= index_[k-1U]*view_.stride(k-1U);
+                    index_[k-1U]     = 0U;
+                }
+                return *this;
+            }
+            constexpr indexed_iterator operator++(int) noexcept{
+                indexed_iterator it(*this);
+                ++*this;
+                return it;
+            }
+            friend constexpr bool operator==(const indexed_iterator& lhs, const indexed_iterator& rhs) noexcept{
+                return lhs.count_ == rhs.count_;
+            }
+            //----------------------------------------------------------------------------------------------------------
+        };
+        template<typename T, size_t N>
+        class indexed_range{
+        private:
+            dynarray_view<T, N> view_; //!<View.
+        public:
+            constexpr explicit indexed_range(const dynarray_view<T, N>& view) noexcept : view_(view){
+            }
+            constexpr indexed_iterator<T, N> begin() const noexcept{
+                return indexed_iterator<T, N>(view_, 0U);
+            }
+            constexpr indexed_iterator<T, N> end() const noexcept{
+                return indexed_iterator<T, N>(view_, view_.size());
+            }
+            constexpr size_t size() const noexcept{
+                return view_.size();
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief View of array (or view) x.
+        //!
+        template<typename X>
+        constexpr auto view_of(X& x) noexcept{
+            if constexpr(is_view_v<X>){
+                return std::remove_cvref_t<X>(x);
+            }
+            else{
+                using T = std::remove_pointer_t<decltype(x.data())>;
+                return dynarray_view<T, std::tuple_size_v<std::remove_cvref_t<decltype(x.extents())>>>(x);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Strided row (pointer plus stride).
+        //!
+        template<typename T>
+        struct strided{
+            T*     head;
+            size_t stride;
+
+            constexpr T& operator[](size_t j) const noexcept{
+                return head[j*stride];
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Call f(n, r0, r...) for each row of views v0, v... (same extents).
+        //! @note  If every view is contiguous, f is called once w/ raw pointers (n = size). Otherwise, it is called for
+        //!        each row of the innermost dimension w/ strided rows, in row-major order. Hence, f should be generic.
+        //!
+        template<typename F, typename T0, size_t N, typename ... T>
+        void for_each_row(F&& f, const dynarray_view<T0, N>& v0, const dynarray_view<T, N>& ... v){
+            if(v0.empty()){
+                return;
+            }
+            if(v0.is_contiguous() && (v.is_contiguous() && ...)){
+                f(v0.size(), v0.data(), v.data()...);
+            }
+            else{
+                const size_t n = v0.extent(N-1U);
+                std::array<size_t, N> idx{};
+                for(size_t r = v0.size()/n; r > 0U; --r){
+                    f(n, strided<T0>{&v0(idx), v0.stride(N-1U)}, strided<T>{&v(idx), v.stride(N-1U)}...);
+                    for(size_t k = N-1U; k > 0U; --k){
+                        if(++idx[k-1U] < v0.extent(k-1U)){
+                            break;
+                        }
+                        idx[k-1U] = 0U;
+                    }
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
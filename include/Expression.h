@@ -0,0 +1,407 @@
+/**
+ * @file    Expression.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Lazy (element-wise) expression templates for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_EXPRESSION_H
+#define DYNARRAY_EXPRESSION_H
+
+#include<algorithm>
+#include<array>
+#include<cmath>
+#include<concepts>
+#include<functional>
+#include<stdexcept>
+
+#include "Auxiliary.h"
+#include "DynArrayView.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Assignment operator (w/ explicit conversion to the destination type).
+        //!
+        struct assign{
+            template<typename X, typename Y>
+            constexpr void operator()(X& x, const Y& y) const{
+                x = detail::convert<X>(y);
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Expression template (base).
+    //! @note  Example: a = b+alpha*c, where a, b and c are vla::dynarray<double, 3> (or views) of the same shape.
+    //!        Operators and functions on arrays/views return lazy expression objects, which are only evaluated (in a
+    //!        single fused pass, w/o temporary arrays) when assigned into an array/view. Shapes are checked at
+    //!        assignment. Expressions hold views, i.e. the operands must outlive them, and the destination should not
+    //!        alias a (differently indexed) operand, e.g. a = a.transpose().
+    //!
+    template<typename E>
+    class expression{
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Derived expression.
+        //!
+        constexpr const E& derived() const noexcept{
+            return static_cast<const E&>(*this);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Evaluate expression into view v, i.e. op(v(i, j, ...), e(i, j, ...)) for each element.
+        //! @note  If both v and every operand are contiguous, the expression is evaluated w/ a single flat loop.
+        //!        Otherwise, it is evaluated row by row (innermost dimension).
+        //!
+        template<typename T, size_t N, typename Op = detail::assign>
+        void evaluate(dynarray_view<T, N> v, Op op = Op{}) const{
+            static_assert(E::rank == N || E::rank == 0U, "expression<E>::evaluate(dynarray_view<T, N>, Op) const");
+            const E& e = derived();
+
+            if(!e.conforms(v.extents())){
+                throw std::invalid_argument("expression<E>::evaluate(dynarray_view<T, N>, Op) const");
+            }
+            if(v.empty()){
+                return;
+            }
+            if(v.is_contiguous() && e.is_contiguous()){
+                T*           p = v.data();
+                const size_t n = v.size();
+                for(size_t i = 0U; i < n; ++i){
+                    op(p[i], e[i]);
+                }
+            }
+            else{
+                const size_t n = v.extent(N-1U);
+                const size_t s = v.stride(N-1U);
+                std::array<size_t, N> idx{};
+                for(size_t r = v.size()/n; r > 0U; --r){
+                    // Row (i(0), i(1), ..., i(N-2), :)...
+                    T*         p   = &v(idx);
+                    const auto row = e.row(idx);
+                    for(size_t j = 0U; j < n; ++j){
+                        op(p[j*s], row[j]);
+                    }
+                    // Next row...
+                    for(size_t k = N-1U; k > 0U; --k){
+                        if(++idx[k-1U] < v.extent(k-1U)){
+                            break;
+                        }
+                        idx[k-1U] = 0U;
+                    }
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether type is an expression/array (view).
+        //!
+        template<typename X>
+        inline constexpr bool is_expression_v = std::derived_from<std::remove_cvref_t<X>,
+                                                                  expression<std::remove_cvref_t<X>>>;
+        template<typename X>
+        inline constexpr bool is_array_v = !is_expression_v<X> && requires(const X& x){
+            x.data();
+            x.stride(0U);
+            std::tuple_size<std::remove_cvref_t<decltype(x.extents())>>::value;
+        };
+        template<typename X>
+        inline constexpr bool is_scalar_v = std::is_arithmetic_v<std::remove_cvref_t<X>>;
+        template<typename ... X>
+        inline constexpr bool is_operand_v = ((is_expression_v<X> || is_array_v<X>) || ...) &&
+                                             ((is_expression_v<X> || is_array_v<X> || is_scalar_v<X>) && ...);
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Scalar (broadcast) expression.
+        //!
+        template<typename S>
+        class scalar : public expression<scalar<S>>{
+        private:
+            S value_;
+        public:
+            using value_type = S;
+            static constexpr size_t rank = 0U;
+
+            constexpr explicit scalar(S value) noexcept : value_(value){
+            }
+            constexpr S operator[](size_t) const noexcept{
+                return value_;
+            }
+            template<size_t R>
+            constexpr bool conforms(const std::array<size_t, R>&) const noexcept{
+                return true;
+            }
+            constexpr bool is_contiguous() const noexcept{
+                return true;
+            }
+            template<size_t R>
+            constexpr scalar row(const std::array<size_t, R>&) const noexcept{
+                return *this;
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Row (strided 1-D) expression.
+        //!
+        template<typename T>
+        class row_view : public expression<row_view<T>>{
+        private:
+            const T* head_;
+            size_t   stride_;
+        public:
+            using value_type = std::remove_cv_t<T>;
+            static constexpr size_t rank = 1U;
+
+            constexpr row_view(const T* head, size_t stride) noexcept : head_(head), stride_(stride){
+            }
+            constexpr const T& operator[](size_t j) const noexcept{
+                return head_[j*stride_];
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Array (view) expression.
+        //!
+        template<typename T, size_t N>
+        class terminal : public expression<terminal<T, N>>{
+        private:
+            dynarray_view<const T, N> view_;
+        public:
+            using value_type = std::remove_cv_t<T>;
+            static constexpr size_t rank = N;
+
+            constexpr explicit terminal(dynarray_view<const T, N> view) noexcept : view_(view){
+            }
+            constexpr const T& operator[](size_t i) const noexcept{
+                return view_.data()[i];
+            }
+            constexpr bool conforms(const std::array<size_t, N>& extents) const noexcept{
+                return view_.extents() == extents;
+            }
+            constexpr bool is_contiguous() const noexcept{
+                return view_.is_contiguous();
+            }
+            constexpr row_view<T> row(const std::array<size_t, N>& idx) const noexcept{
+                return row_view<T>(&view_(idx), view_.stride(N-1U));
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Unary expression.
+        //!
+        template<typename F, typename E>
+        class unary : public expression<unary<F, E>>{
+        private:
+            F f_;
+            E e_;
+        public:
+            using value_type = std::remove_cvref_t<std::invoke_result_t<const F&, typename E::value_type>>;
+            static constexpr size_t rank = E::rank;
+
+            constexpr unary(F f, E e) noexcept : f_(f), e_(e){
+            }
+            constexpr value_type operator[](size_t i) const{
+                return f_(e_[i]);
+            }
+            template<size_t R>
+            constexpr bool conforms(const std::array<size_t, R>& extents) const noexcept{
+                return e_.conforms(extents);
+            }
+            constexpr bool is_contiguous() const noexcept{
+                return e_.is_contiguous();
+            }
+            template<size_t R>
+            constexpr auto row(const std::array<size_t, R>& idx) const noexcept{
+                return unary<F, decltype(e_.row(idx))>(f_, e_.row(idx));
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Binary expression.
+        //!
+        template<typename F, typename L, typename R>
+        class binary : public expression<binary<F, L, R>>{
+            static_assert(L::rank == R::rank || L::rank == 0U || R::rank == 0U, "binary<F, L, R>: rank mismatch.");
+        private:
+            F f_;
+            L l_;
+            R r_;
+        public:
+            using value_type = std::remove_cvref_t<std::invoke_result_t<const F&, typename L::value_type,
+                                                                                  typename R::value_type>>;
+            static constexpr size_t rank = std::max(L::rank, R::rank);
+
+            constexpr binary(F f, L l, R r) noexcept : f_(f), l_(l), r_(r){
+            }
+            constexpr value_type operator[](size_t i) const{
+                return f_(l_[i], r_[i]);
+            }
+            template<size_t M>
+            constexpr bool conforms(const std::array<size_t, M>& extents) const noexcept{
+                return l_.conforms(extents) && r_.conforms(extents);
+            }
+            constexpr bool is_contiguous() const noexcept{
+                return l_.is_contiguous() && r_.is_contiguous();
+            }
+            template<size_t M>
+            constexpr auto row(const std::array<size_t, M>& idx) const noexcept{
+                return binary<F, decltype(l_.row(idx)), decltype(r_.row(idx))>(f_, l_.row(idx), r_.row(idx));
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Wrap operand (expression, array/view or scalar) into an expression.
+        //!
+        template<typename X>
+        constexpr auto operand(const X& x) noexcept{
+            if constexpr(is_expression_v<X>){
+                return x;
+            }
+            else if constexpr(is_scalar_v<X>){
+                return scalar<X>(x);
+            }
+            else{
+                using T = std::remove_cv_t<std::remove_pointer_t<decltype(x.data())>>;
+                constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<decltype(x.extents())>>;
+                return terminal<T, N>(view_of(x));
+            }
+        }
+        template<typename F, typename X>
+        constexpr auto make_unary(F f, const X& x) noexcept{
+            return unary<F, decltype(operand(x))>(f, operand(x));
+        }
+        template<typename F, typename L, typename R>
+        constexpr auto make_binary(F f, const L& l, const R& r) noexcept{
+            return binary<F, decltype(operand(l)), decltype(operand(r))>(f, operand(l), operand(r));
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Non-member functions: operator+ .
+    //!                              operator- .
+    //!                              operator* .
+    //!                              operator/ .
+    //!
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto operator+(const X& x) noexcept{
+        return detail::operand(x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto operator-(const X& x) noexcept{
+        return detail::make_unary(std::negate<>{}, x);
+    }
+    template<typename L, typename R> requires(detail::is_operand_v<L, R>)
+    constexpr auto operator+(const L& l, const R& r) noexcept{
+        return detail::make_binary(std::plus<>{}, l, r);
+    }
+    template<typename L, typename R> requires(detail::is_operand_v<L, R>)
+    constexpr auto operator-(const L& l, const R& r) noexcept{
+        return detail::make_binary(std::minus<>{}, l, r);
+    }
+    template<typename L, typename R> requires(detail::is_operand_v<L, R>)
+    constexpr auto operator*(const L& l, const R& r) noexcept{
+        return detail::make_binary(std::multiplies<>{}, l, r);
+    }
+    template<typename L, typename R> requires(detail::is_operand_v<L, R>)
+    constexpr auto operator/(const L& l, const R& r) noexcept{
+        return detail::make_binary(std::divides<>{}, l, r);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Non-member functions: abs.
+    //!                              sqrt.
+    //!                              cbrt.
+    //!                              exp.
+    //!                              log.
+    //!                              log10.
+    //!                              sin.
+    //!                              cos.
+    //!                              tan.
+    //!                              tanh.
+    //!                              floor.
+    //!                              ceil.
+    //!                              pow.
+    //!                              min.
+    //!                              max.
+    //!
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto abs(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::abs; return abs(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto sqrt(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::sqrt; return sqrt(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto cbrt(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::cbrt; return cbrt(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto exp(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::exp; return exp(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto log(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::log; return log(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto log10(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::log10; return log10(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto sin(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::sin; return sin(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto cos(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::cos; return cos(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto tan(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::tan; return tan(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto tanh(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::tanh; return tanh(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto floor(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::floor; return floor(y);}, x);
+    }
+    template<typename X> requires(detail::is_operand_v<X>)
+    constexpr auto ceil(const X& x) noexcept{
+        return detail::make_unary([](const auto& y){using std::ceil; return ceil(y);}, x);
+    }
+    template<typename L, typename R> requires(detail::is_operand_v<L, R>)
+    constexpr auto pow(const L& l, const R& r) noexcept{
+        return detail::make_binary([](const auto& x, const auto& y){using std::pow; return pow(x, y);}, l, r);
+    }
+    template<typename L, typename R> requires(detail::is_operand_v<L, R>)
+    constexpr auto min(const L& l, const R& r) noexcept{
+        return detail::make_binary([](const auto& x, const auto& y){return y < x ? y : x;}, l, r);
+    }
+    template<typename L, typename R> requires(detail::is_operand_v<L, R>)
+    constexpr auto max(const L& l, const R& r) noexcept{
+        return detail::make_binary([](const auto& x, const auto& y){return x < y ? y : x;}, l, r);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
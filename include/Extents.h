@@ -0,0 +1,175 @@
+/**
+ * @file    Extents.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Mixed compile-time/run-time extents.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_EXTENTS_H
+#define DYNARRAY_EXTENTS_H
+
+#include<array>
+#include<limits>
+#include<type_traits>
+#include<utility>
+
+#include "Auxiliary.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Dynamic (run-time) extent tag.
+    //!
+    inline constexpr size_t dyn = std::numeric_limits<size_t>::max();
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief N-D extents template (row-major), each of which is either static (known at compile time) or dyn.
+    //! @note  Example: vla::extents<vla::dyn, 3> e(n) : nx3 extents (only n is stored).
+    //!        Static extents (and the strides and offsets computed from them) are compile-time constants, e.g.
+    //!        e.stride<0>() = 3 and e.offset(i, j) = 3*i+j.
+    //!
+    template<size_t ... E>
+    class extents{
+        static_assert(sizeof ... (E) > 0U, "extents<E ...>: rank must be positive.");
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary constants.
+        //!
+        static constexpr size_t                N       = sizeof ... (E);               //!<Rank.
+        static constexpr size_t                D       = ((E == dyn ? 1U : 0U)+...);   //!<Dynamic rank.
+        static constexpr std::array<size_t, N> static_ = {E ...};                      //!<Static extents (or dyn).
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        std::array<size_t, D> dynamic_; //!<Dynamic extents.
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::extents<vla::dyn, 3> e    : 0x3 extents.
+        //!                 vla::extents<vla::dyn, 3> e(4) : 4x3 extents.
+        //!
+        constexpr extents() noexcept : dynamic_{}{
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == D && D > 0U)
+        constexpr explicit extents(Idx ... n) noexcept : dynamic_{detail::index(n)...}{
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: rank.
+        //!                  rank_dynamic.
+        //!                  static_extent.
+        //!                  extent.
+        //!                  stride.
+        //!                  size.
+        //!                  array.
+        //!
+        static constexpr size_t rank() noexcept{
+            return N;
+        }
+        static constexpr size_t rank_dynamic() noexcept{
+            return D;
+        }
+        static constexpr size_t static_extent(size_t k) noexcept{
+            return static_[k];
+        }
+        template<size_t K>
+        constexpr size_t extent() const noexcept{
+            if constexpr(static_[K] == dyn){
+                return dynamic_[dynamic_index(K)];
+            }
+            else{
+                return static_[K];
+            }
+        }
+        constexpr size_t extent(size_t k) const noexcept{
+            return static_[k] == dyn ? dynamic_[dynamic_index(k)] : static_[k];
+        }
+        template<size_t K>
+        constexpr size_t stride() const noexcept{
+            return product<K+1U>(std::make_index_sequence<N-K-1U>{});
+        }
+        constexpr size_t stride(size_t k) const noexcept{
+            size_t s = 1U;
+            for(size_t j = k+1U; j < N; ++j){
+                s *= extent(j);
+            }
+            return s;
+        }
+        constexpr size_t size() const noexcept{
+            return product<0U>(std::make_index_sequence<N>{});
+        }
+        constexpr std::array<size_t, N> array() const noexcept{
+            std::array<size_t, N> n{};
+            for(size_t k = 0U; k < N; ++k){
+                n[k] = extent(k);
+            }
+            return n;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Offset of element (i(0), i(1), ...): ((i(0)*n(1)+i(1))*n(2)+i(2))*...
+        //!
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        constexpr size_t offset(Idx ... i) const noexcept{
+            return offset(std::make_index_sequence<N>{}, i...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator== .
+        //!
+        friend constexpr bool operator==(const extents& lhs, const extents& rhs) noexcept{
+            return lhs.dynamic_ == rhs.dynamic_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        static constexpr size_t dynamic_index(size_t k) noexcept{
+            size_t d = 0U;
+            for(size_t j = 0U; j < k; ++j){
+                d += static_[j] == dyn ? 1U : 0U;
+            }
+            return d;
+        }
+        template<size_t K, size_t ... J>
+        constexpr size_t product(std::index_sequence<J...>) const noexcept{
+            return (size_t(1U)*...*extent<K+J>());
+        }
+        template<size_t ... K, typename ... Idx>
+        constexpr size_t offset(std::index_sequence<K...>, Idx ... i) const noexcept{
+            size_t o = 0U;
+            ((o = o*extent<K>()+detail::index(i)), ...);
+            return o;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether type is an extents<E ...>.
+        //!
+        template<typename E>
+        struct is_extents : std::false_type{
+        };
+        template<size_t ... E>
+        struct is_extents<extents<E...>> : std::true_type{
+        };
+        template<typename E>
+        inline constexpr bool is_extents_v = is_extents<std::remove_cvref_t<E>>::value;
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,330 @@
+/**
+ * @file    Indirect.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Batched gather/scatter through index arrays (indirect addressing) for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_INDIRECT_H
+#define DYNARRAY_INDIRECT_H
+
+#include<algorithm>
+#include<stdexcept>
+#include<type_traits>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include<immintrin.h>
+#endif
+
+#include "Auxiliary.h"
+#include "DynArray.h"
+#include "DynArrayView.h"
+#include "Numeric.h"
+#include "Parallel.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Software prefetch distance (elements ahead) of the indirect loops.
+        //!
+        inline constexpr size_t prefetch_distance = 32U;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Software prefetch of address p (for writing if Write), a no-op w/o GCC/Clang builtins.
+        //!
+        template<bool Write = false, typename T>
+        [[gnu::always_inline]] inline void prefetch([[maybe_unused]] const T* p) noexcept{
+#if defined(__GNUC__)
+            __builtin_prefetch(p, Write ? 1 : 0);
+#endif
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Whether the hardware gather/scatter kernels apply: 4/8-byte elements (moved as raw integers) and
+        //!        64-bit (size_t) indices.
+        //!
+        template<typename T, typename I>
+        inline constexpr bool is_hardware_gather_v = std::is_trivially_copyable_v<T> &&
+            (sizeof(T) == 4U || sizeof(T) == 8U) && std::is_same_v<I, size_t> && sizeof(size_t) == 8U;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Kernels (contiguous source/index/destination): gather  (d[i] = s[k[i]]).
+        //!                                                       scatter (d[k[i]] = s[i], in order).
+        //!
+        template<typename T, typename I>
+        struct gather{
+            [[gnu::always_inline]] static void run(const T* s, const I* k, T* d, size_t n) noexcept{
+                size_t i = 0U;
+                for(; i+prefetch_distance < n; ++i){
+                    prefetch(s+k[i+prefetch_distance]);
+                    d[i] = s[k[i]];
+                }
+                for(; i < n; ++i){
+                    d[i] = s[k[i]];
+                }
+            }
+        };
+        template<typename T, typename I>
+        struct scatter{
+            [[gnu::always_inline]] static void run(const T* s, const I* k, T* d, size_t n) noexcept{
+                size_t i = 0U;
+                for(; i+prefetch_distance < n; ++i){
+                    prefetch<true>(d+k[i+prefetch_distance]);
+                    d[k[i]] = s[i];
+                }
+                for(; i < n; ++i){
+                    d[k[i]] = s[i];
+                }
+            }
+        };
+#if defined(__GNUC__) && defined(__x86_64__)
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Hardware gather (AVX2/AVX-512) and scatter (AVX-512) kernels, see is_hardware_gather_v.
+        //! @note  AVX-512 scatters write overlapping lanes in lane order, hence duplicate indices keep the last value
+        //!        (as the scalar kernel).
+        //!
+        template<typename T>
+        [[gnu::target("avx2")]] void gather_avx2(const T* s, const size_t* k, T* d, size_t n) noexcept{
+            const auto* b = static_cast<const void*>(s);
+            size_t i = 0U;
+            for(; i+4U <= n; i += 4U){
+                if(i+prefetch_distance < n){
+                    prefetch(s+k[i+prefetch_distance]);
+                }
+                const __m256i v = _mm256_loadu_si256(static_cast<const __m256i*>(static_cast<const void*>(k+i)));
+                if constexpr(sizeof(T) == 8U){
+                    const __m256i x = _mm256_i64gather_epi64(static_cast<const long long*>(b), v, 8);
+                    _mm256_storeu_si256(static_cast<__m256i*>(static_cast<void*>(d+i)), x);
+                }
+                else{
+                    const __m128i x = _mm256_i64gather_epi32(static_cast<const int*>(b), v, 4);
+                    _mm_storeu_si128(static_cast<__m128i*>(static_cast<void*>(d+i)), x);
+                }
+            }
+            gather<T, size_t>::run(s, k+i, d+i, n-i);
+        }
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"     // GCC's AVX-512 gather/scatter macros (-O0) pass 0xFF as char,
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // and their inline versions (-O1+) an undefined pass-through.
+        template<typename T>
+        [[gnu::target("avx512f")]] void gather_avx512(const T* s, const size_t* k, T* d, size_t n) noexcept{
+            size_t i = 0U;
+            for(; i+8U <= n; i += 8U){
+                if(i+prefetch_distance < n){
+                    prefetch(s+k[i+prefetch_distance]);
+                }
+                const __m512i v = _mm512_loadu_si512(k+i);
+                if constexpr(sizeof(T) == 8U){
+                    _mm512_storeu_si512(d+i, _mm512_i64gather_epi64(v, static_cast<const void*>(s), 8));
+                }
+                else{
+                    const __m256i x = _mm512_i64gather_epi32(v, static_cast<const void*>(s), 4);
+                    _mm256_storeu_si256(static_cast<__m256i*>(static_cast<void*>(d+i)), x);
+                }
+            }
+            gather<T, size_t>::run(s, k+i, d+i, n-i);
+        }
+        template<typename T>
+        [[gnu::target("avx512f")]] void scatter_avx512(const T* s, const size_t* k, T* d, size_t n) noexcept{
+            size_t i = 0U;
+            for(; i+8U <= n; i += 8U){
+                if(i+prefetch_distance < n){
+                    prefetch<true>(d+k[i+prefetch_distance]);
+                }
+                const __m512i v = _mm512_loadu_si512(k+i);
+                if constexpr(sizeof(T) == 8U){
+                    _mm512_i64scatter_epi64(static_cast<void*>(d), v, _mm512_loadu_si512(s+i), 8);
+                }
+                else{
+                    const __m256i x = _mm256_loadu_si256(static_cast<const __m256i*>(static_cast<const void*>(s+i)));
+                    _mm512_i64scatter_epi32(static_cast<void*>(d), v, x, 4);
+                }
+            }
+            scatter<T, size_t>::run(s+i, k+i, d, n-i);
+        }
+#pragma GCC diagnostic pop
+#endif
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Gather/scatter n contiguous elements w/ the selected instruction set (see numeric::set_isa).
+        //!
+        template<typename T, typename I>
+        void gather_n(const T* s, const I* k, T* d, size_t n) noexcept{
+#if defined(__GNUC__) && defined(__x86_64__)
+            if constexpr(is_hardware_gather_v<T, I>){
+                switch(numeric::current_isa()){
+                    case numeric::isa::avx512:
+                        return gather_avx512(s, k, d, n);
+                    case numeric::isa::avx2:
+                        return gather_avx2(s, k, d, n);
+                    default:
+                        break;
+                }
+            }
+#endif
+            gather<T, I>::run(s, k, d, n);
+        }
+        template<typename T, typename I>
+        void scatter_n(const T* s, const I* k, T* d, size_t n) noexcept{
+#if defined(__GNUC__) && defined(__x86_64__)
+            if constexpr(is_hardware_gather_v<T, I>){
+                if(numeric::current_isa() == numeric::isa::avx512){
+                    return scatter_avx512(s, k, d, n);
+                }
+            }
+#endif
+            scatter<T, I>::run(s, k, d, n);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Gather (Scatter = false) or scatter (Scatter = true) positions [first, last) of index view vk.
+        //!
+        template<bool Scatter, typename VS, typename VK, typename VD>
+        void indirect_range(const VS& vs, const VK& vk, const VD& vd, size_t first, size_t last){
+            using T = std::remove_cv_t<std::remove_pointer_t<decltype(vs.data())>>;
+            using U = std::remove_pointer_t<decltype(vd.data())>;
+            using I = std::remove_cv_t<std::remove_pointer_t<decltype(vk.data())>>;
+            if constexpr(std::is_same_v<T, U>){
+                if(vs.stride(0U) == 1U && vk.stride(0U) == 1U && vd.stride(0U) == 1U){
+                    if constexpr(Scatter){
+                        scatter_n<T, I>(vs.data()+first, vk.data()+first, vd.data(), last-first);
+                    }
+                    else{
+                        gather_n<T, I>(vs.data(), vk.data()+first, vd.data()+first, last-first);
+                    }
+                    return;
+                }
+            }
+            for(size_t i = first; i < last; ++i){
+                if constexpr(Scatter){
+                    vd(detail::index(vk(i))) = vs(i);
+                }
+                else{
+                    vd(i) = vs(detail::index(vk(i)));
+                }
+            }
+        }
+        template<bool Scatter, typename VS, typename VK, typename VD>
+        void check_indirect(const VS& vs, const VK& vk, const VD& vd, const char* what){
+            static_assert(std::is_integral_v<std::remove_cv_t<std::remove_pointer_t<decltype(vk.data())>>>);
+            if((Scatter ? vs.size() : vd.size()) != vk.size()){
+                throw std::invalid_argument(what);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Indirect addressing: gather  (dst(i) = src(idx(i)) for each i < idx.size()).
+    //!                             scatter (dst(idx(i)) = src(i), or op(dst(idx(i)), src(i)), for each i < idx.size()).
+    //! @note  Example: vla::gather(field, cell_of_face, face_value)             : face_value(f) = field(cell(f)).
+    //!                 vla::scatter(flux, cell_of_face, residual, std::plus<>{}) : residual(cell(f)) += flux(f).
+    //!                 vla::gather(field, cell_of_face, face_value, {})         : in parallel (default policy).
+    //!        src, idx and dst are 1-D arrays or views; indices are not checked (as operator[]). idx and dst (gather)
+    //!        or idx and src (scatter) must have the same size (std::invalid_argument otherwise). Contiguous operands
+    //!        w/ size_t indices and 4/8-byte elements use hardware gathers (AVX2, AVX-512) and scatters (AVX-512) of
+    //!        the selected instruction set (see numeric::set_isa); every kernel prefetches prefetch_distance indices
+    //!        ahead. Scatters w/ duplicate indices keep the last value, except in parallel (unspecified), and the op
+    //!        overload is sequential (see Accumulation.h for concurrent accumulation). See locality_order to improve
+    //!        the locality of the indirect accesses.
+    //!
+    template<typename S, typename K, typename D>
+    void gather(const S& src, const K& idx, D&& dst){
+        const auto vs = detail::view_of(src);
+        const auto vk = detail::view_of(idx);
+        const auto vd = detail::view_of(dst);
+        detail::check_indirect<false>(vs, vk, vd, "vla::gather(const S&, const K&, D&&)");
+        detail::indirect_range<false>(vs, vk, vd, 0U, vk.size());
+    }
+    template<typename S, typename K, typename D>
+    void gather(const S& src, const K& idx, D&& dst, const parallel::policy& p){
+        const auto vs = detail::view_of(src);
+        const auto vk = detail::view_of(idx);
+        const auto vd = detail::view_of(dst);
+        detail::check_indirect<false>(vs, vk, vd, "vla::gather(const S&, const K&, D&&, const parallel::policy&)");
+        parallel::policy q = p;
+        q.grain = parallel::detail::grain(p, vk);
+        parallel::for_range(vk.size(), [&](size_t first, size_t last){
+            detail::indirect_range<false>(vs, vk, vd, first, last);
+        }, q);
+    }
+    template<typename S, typename K, typename D>
+    void scatter(const S& src, const K& idx, D&& dst){
+        const auto vs = detail::view_of(src);
+        const auto vk = detail::view_of(idx);
+        const auto vd = detail::view_of(dst);
+        detail::check_indirect<true>(vs, vk, vd, "vla::scatter(const S&, const K&, D&&)");
+        detail::indirect_range<true>(vs, vk, vd, 0U, vk.size());
+    }
+    template<typename S, typename K, typename D>
+    void scatter(const S& src, const K& idx, D&& dst, const parallel::policy& p){
+        const auto vs = detail::view_of(src);
+        const auto vk = detail::view_of(idx);
+        const auto vd = detail::view_of(dst);
+        detail::check_indirect<true>(vs, vk, vd, "vla::scatter(const S&, const K&, D&&, const parallel::policy&)");
+        parallel::policy q = p;
+        q.grain = parallel::detail::grain(p, vk);
+        parallel::for_range(vk.size(), [&](size_t first, size_t last){
+            detail::indirect_range<true>(vs, vk, vd, first, last);
+        }, q);
+    }
+    template<typename S, typename K, typename D, typename R> requires(!std::is_same_v<R, parallel::policy>)
+    void scatter(const S& src, const K& idx, D&& dst, R op){
+        const auto vs = detail::view_of(src);
+        const auto vk = detail::view_of(idx);
+        const auto vd = detail::view_of(dst);
+        detail::check_indirect<true>(vs, vk, vd, "vla::scatter(const S&, const K&, D&&, R)");
+        for(size_t i = 0U; i < vk.size(); ++i){
+            if(i+detail::prefetch_distance < vk.size()){
+                detail::prefetch<true>(&vd(detail::index(vk(i+detail::prefetch_distance))));
+            }
+            auto& y = vd(detail::index(vk(i)));
+            y = op(y, vs(i));
+        }
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Locality order (bucketing prepass): permutation p s.t. idx(p(0)), idx(p(1)), ... visit the buckets of
+    //!        bucket consecutive indices in increasing order (stable counting sort, O(n+max(idx)/bucket)).
+    //! @note  Example: const auto p = vla::locality_order(cell_of_face);
+    //!                 vla::gather(cell_of_face, p, sorted)  : renumbered faces (e.g. once, after reading the mesh).
+    //!        Applied once to static connectivity (renumbering the loop), subsequent gathers/scatters through the
+    //!        reordered indices sweep the target array (nearly) sequentially. bucket = 1: full sort by index.
+    //!
+    template<typename K>
+    dynarray<size_t> locality_order(const K& idx, size_t bucket = 512U){
+        const auto vk = detail::view_of(idx);
+        if(bucket == 0U){
+            throw std::invalid_argument("vla::locality_order(const K&, size_t)");
+        }
+        dynarray<size_t> p(vk.size());
+        if(vk.empty()){
+            return p;
+        }
+        size_t m = 0U;
+        for(size_t i = 0U; i < vk.size(); ++i){
+            m = std::max(m, detail::index(vk(i))/bucket);
+        }
+        dynarray<size_t> count(m+2U);
+        for(size_t i = 0U; i < vk.size(); ++i){
+            ++count[detail::index(vk(i))/bucket+1U];
+        }
+        for(size_t b = 1U; b < count.size(); ++b){
+            count[b] += count[b-1U];
+        }
+        for(size_t i = 0U; i < vk.size(); ++i){
+            p[count[detail::index(vk(i))/bucket]++] = i;
+        }
+        return p;
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
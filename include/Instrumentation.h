@@ -0,0 +1,259 @@
+/**
+ * @file    Instrumentation.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Allocation counters and counting allocator (opt-in memory instrumentation).
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_INSTRUMENTATION_H
+#define DYNARRAY_INSTRUMENTATION_H
+
+#include<atomic>
+#include<memory>
+#include<ostream>
+#include<type_traits>
+
+#include "Auxiliary.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Allocation statistics.
+    //! @note  Example: const auto s = vla::memory::stats();
+    //!                 ... (hot loop)
+    //!                 std::cout << vla::memory::stats()-s : allocations/deallocations/bytes of the hot loop.
+    //!
+    namespace memory{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Allocation statistics (snapshot).
+        //!
+        struct statistics{
+            size_t allocations;   //!<Number of allocate   calls.
+            size_t deallocations; //!<Number of deallocate calls.
+            size_t allocated;     //!<Bytes allocated   (total).
+            size_t deallocated;   //!<Bytes deallocated (total).
+            size_t peak;          //!<Bytes in use      (peak).
+            //----------------------------------------------------------------------------------------------------------
+            //!
+            //! @brief Capacity: bytes (in use).
+            //!
+            size_t bytes() const noexcept{
+                return allocated > deallocated ? allocated-deallocated : 0U;
+            }
+            //----------------------------------------------------------------------------------------------------------
+            //!
+            //! @brief Non-member functions: operator-  (difference between two snapshots, peak is kept).
+            //!                              operator<< .
+            //!
+            friend statistics operator-(const statistics& lhs, const statistics& rhs) noexcept{
+                return {lhs.allocations-rhs.allocations, lhs.deallocations-rhs.deallocations,
+                        lhs.allocated-rhs.allocated, lhs.deallocated-rhs.deallocated, lhs.peak};
+            }
+            friend std::ostream& operator<<(std::ostream& os, const statistics& s){
+                return os << "allocations: " << s.allocations << " (" << s.allocated << " bytes), "
+                          << "deallocations: " << s.deallocations << " (" << s.deallocated << " bytes), "
+                          << "in use: " << s.bytes() << " bytes, peak: " << s.peak << " bytes";
+            }
+            //----------------------------------------------------------------------------------------------------------
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Tracer (called on every allocate/deallocate of a counting allocator w/ the address, the number of
+        //!        bytes and whether it is an allocation), e.g. to log or break on allocations inside a hot loop.
+        //!
+        using tracer = void(*)(const void*, size_t, bool);
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        namespace detail{
+            //----------------------------------------------------------------------------------------------------------
+            //!
+            //! @brief Allocation counters (thread-safe).
+            //!
+            struct counters{
+                std::atomic<size_t> allocations{0U};
+                std::atomic<size_t> deallocations{0U};
+                std::atomic<size_t> allocated{0U};
+                std::atomic<size_t> deallocated{0U};
+                std::atomic<size_t> peak{0U};
+                //------------------------------------------------------------------------------------------------------
+                void allocate(size_t n) noexcept{
+                    allocations.fetch_add(1U, std::memory_order_relaxed);
+                    const size_t a = allocated.fetch_add(n, std::memory_order_relaxed)+n;
+                    const size_t d = deallocated.load(std::memory_order_relaxed);
+                    const size_t b = a > d ? a-d : 0U;
+                    size_t p = peak.load(std::memory_order_relaxed);
+                    while(b > p && !peak.compare_exchange_weak(p, b, std::memory_order_relaxed)){
+                    }
+                }
+                void deallocate(size_t n) noexcept{
+                    deallocations.fetch_add(1U, std::memory_order_relaxed);
+                    deallocated.fetch_add(n, std::memory_order_relaxed);
+                }
+                statistics load() const noexcept{
+                    return {allocations.load(std::memory_order_relaxed), deallocations.load(std::memory_order_relaxed),
+                            allocated.load(std::memory_order_relaxed), deallocated.load(std::memory_order_relaxed),
+                            peak.load(std::memory_order_relaxed)};
+                }
+                void reset() noexcept{
+                    allocations.store(0U, std::memory_order_relaxed);
+                    deallocations.store(0U, std::memory_order_relaxed);
+                    allocated.store(0U, std::memory_order_relaxed);
+                    deallocated.store(0U, std::memory_order_relaxed);
+                    peak.store(0U, std::memory_order_relaxed);
+                }
+                //------------------------------------------------------------------------------------------------------
+            };
+            //----------------------------------------------------------------------------------------------------------
+            //!
+            //! @brief Process-wide counters and tracer.
+            //!
+            inline counters& global() noexcept{
+                static counters c;
+                return c;
+            }
+            inline std::atomic<tracer>& trace() noexcept{
+                static std::atomic<tracer> t{nullptr};
+                return t;
+            }
+            //----------------------------------------------------------------------------------------------------------
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Process-wide statistics of all counting allocators: stats.
+        //!                                                            reset.
+        //!                                                            set_tracer (nullptr to disable tracing).
+        //!
+        inline statistics stats() noexcept{
+            return detail::global().load();
+        }
+        inline void reset() noexcept{
+            detail::global().reset();
+        }
+        inline tracer set_tracer(tracer t) noexcept{
+            return detail::trace().exchange(t);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Counting allocator template (adapter over allocator A).
+    //! @note  Example: vla::dynarray<double, 3, vla::counting_allocator> a(nx, ny, nz)
+    //!                 a.allocation_count() : allocations made by a (a.get_allocator().stats() for all statistics).
+    //!                 vla::memory::stats() : allocations made by all counting allocators.
+    //!        Other allocators are wrapped via an alias, e.g.
+    //!        template<typename T> using counted = vla::counting_allocator<T, vla::padded_allocator>.
+    //!        Each array gets its own counters (copies of an array start from zero, moves/swaps carry them along).
+    //!
+    template<typename T, template<typename U> typename A = std::allocator>
+    class counting_allocator{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using type_a = A<T>;                                     //!<Type allocator alias.
+        using traits = std::allocator_traits<type_a>;            //!<Type traits    alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        [[no_unique_address]] type_a               allocator_; //!<Allocator.
+        std::shared_ptr<memory::detail::counters> counters_;  //!<Counters (per array).
+        //--------------------------------------------------------------------------------------------------------------
+        template<typename, template<typename> typename>
+        friend class counting_allocator;
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using value_type                             = T;
+        using size_type                              = size_t;
+        using difference_type                        = size_d;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+        using is_always_equal                        = std::false_type;
+        template<typename U>
+        struct rebind{
+            using other = counting_allocator<U, A>;
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member constants.
+        //!
+        static constexpr size_t padding = vla::detail::padding<type_a>(); //!<Elements (see aligned_allocator).
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //!
+        counting_allocator() : counting_allocator(type_a()){
+        }
+        explicit counting_allocator(const type_a& allocator) :
+            allocator_(allocator), counters_(std::make_shared<memory::detail::counters>()){
+        }
+        template<typename U>
+        counting_allocator(const counting_allocator<U, A>& other) noexcept : allocator_(other.allocator_),
+                                                                             counters_(other.counters_){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy of a container (fresh counters).
+        //!
+        counting_allocator select_on_container_copy_construction() const{
+            return counting_allocator(traits::select_on_container_copy_construction(allocator_));
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Allocate/deallocate n elements.
+        //!
+        [[nodiscard]] T* allocate(size_t n){
+            T* p = allocator_.allocate(n);
+            counters_->allocate(n*sizeof(T));
+            memory::detail::global().allocate(n*sizeof(T));
+            if(const memory::tracer t = memory::detail::trace().load(std::memory_order_relaxed)){
+                t(p, n*sizeof(T), true);
+            }
+            return p;
+        }
+        void deallocate(T* p, size_t n) noexcept{
+            counters_->deallocate(n*sizeof(T));
+            memory::detail::global().deallocate(n*sizeof(T));
+            if(const memory::tracer t = memory::detail::trace().load(std::memory_order_relaxed)){
+                t(p, n*sizeof(T), false);
+            }
+            allocator_.deallocate(p, n);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Statistics: stats.
+        //!                    allocation_count.
+        //!
+        memory::statistics stats() const noexcept{
+            return counters_->load();
+        }
+        size_t allocation_count() const noexcept{
+            return counters_->allocations.load(std::memory_order_relaxed);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator== (memory allocated by one can be deallocated by the other).
+        //!                              operator!= .
+        //!
+        friend bool operator==(const counting_allocator& lhs, const counting_allocator& rhs) noexcept{
+            return lhs.allocator_ == rhs.allocator_;
+        }
+        friend bool operator!=(const counting_allocator& lhs, const counting_allocator& rhs) noexcept{
+            return !(lhs == rhs);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file    Layout.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Memory layout policies (index -> offset mappings) for the N-D array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_LAYOUT_H
+#define DYNARRAY_LAYOUT_H
+
+#include<algorithm>
+#include<array>
+#include<type_traits>
+#include<utility>
+
+#include "Auxiliary.h"
+#include "Extents.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Call f(i) for each index i of box [first, last), where order(0) is the slowest varying dimension and
+        //!        order(N-1) the fastest one.
+        //!
+        template<size_t N, typename F>
+        constexpr void for_each_index(const std::array<size_t, N>& first, const std::array<size_t, N>& last,
+                                      const std::array<size_t, N>& order, F&& f){
+            for(size_t k = 0U; k < N; ++k){
+                if(first[k] >= last[k]){
+                    return;
+                }
+            }
+            std::array<size_t, N> i = first;
+            while(true){
+                f(static_cast<const std::array<size_t, N>&>(i));
+                size_t k = N;
+                while(k > 0U && ++i[order[k-1U]] == last[order[k-1U]]){
+                    i[order[k-1U]] = first[order[k-1U]];
+                    --k;
+                }
+                if(k == 0U){
+                    return;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Dimension order (slowest to fastest varying): row-major (k) or column-major (N-1-k).
+        //!
+        template<size_t N>
+        constexpr std::array<size_t, N> order(bool reversed) noexcept{
+            std::array<size_t, N> o{};
+            for(size_t k = 0U; k < N; ++k){
+                o[k] = reversed ? N-1U-k : k;
+            }
+            return o;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Row-major layout (last index varies fastest, as for vla::dynarray<T, N, A>).
+    //! @note  Element (i(0), i(1), ...) lives at offset ((i(0)*n(1)+i(1))*n(2)+i(2))*...
+    //!
+    struct layout_right{
+        template<typename E>
+        class mapping{
+        private:
+            static constexpr size_t N = E::rank(); //!<Rank.
+            E extents_;                            //!<Extents.
+        public:
+            static constexpr bool                  is_strided = true;                           //!<Strided (view).
+            static constexpr std::array<size_t, N> order      = detail::order<N>(false);        //!<Dimension order.
+            //----------------------------------------------------------------------------------------------------------
+            constexpr mapping() noexcept = default;
+            constexpr explicit mapping(const E& extents) noexcept : extents_(extents){
+            }
+            constexpr const E& extents() const noexcept{
+                return extents_;
+            }
+            constexpr size_t span() const noexcept{
+                return extents_.size();
+            }
+            constexpr size_t stride(size_t k) const noexcept{
+                return extents_.stride(k);
+            }
+            template<typename ... Idx> requires(sizeof ... (Idx) == N)
+            constexpr size_t operator()(Idx ... i) const noexcept{
+                return extents_.offset(i...);
+            }
+            constexpr size_t offset(const std::array<size_t, N>& i) const noexcept{
+                size_t o = 0U;
+                for(size_t k = 0U; k < N; ++k){
+                    o = o*extents_.extent(k)+i[k];
+                }
+                return o;
+            }
+            template<typename F>
+            constexpr void for_each_index(F&& f) const{
+                detail::for_each_index(std::array<size_t, N>{}, extents_.array(), order, f);
+            }
+            friend constexpr bool operator==(const mapping&, const mapping&) noexcept = default;
+            //----------------------------------------------------------------------------------------------------------
+        };
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Column-major layout (first index varies fastest, as in Fortran).
+    //! @note  Element (i(0), i(1), ...) lives at offset i(0)+n(0)*(i(1)+n(1)*(i(2)+...)), i.e. sweeps along the first
+    //!        dimension are unit-stride.
+    //!
+    struct layout_left{
+        template<typename E>
+        class mapping{
+        private:
+            static constexpr size_t N = E::rank(); //!<Rank.
+            E extents_;                            //!<Extents.
+        public:
+            static constexpr bool                  is_strided = true;                           //!<Strided (view).
+            static constexpr std::array<size_t, N> order      = detail::order<N>(true);         //!<Dimension order.
+            //----------------------------------------------------------------------------------------------------------
+            constexpr mapping() noexcept = default;
+            constexpr explicit mapping(const E& extents) noexcept : extents_(extents){
+            }
+            constexpr const E& extents() const noexcept{
+                return extents_;
+            }
+            constexpr size_t span() const noexcept{
+                return extents_.size();
+            }
+            constexpr size_t stride(size_t k) const noexcept{
+                size_t s = 1U;
+                for(size_t j = 0U; j < k; ++j){
+                    s *= extents_.extent(j);
+                }
+                return s;
+            }
+            template<typename ... Idx> requires(sizeof ... (Idx) == N)
+            constexpr size_t operator()(Idx ... i) const noexcept{
+                return offset({detail::index(i)...});
+            }
+            constexpr size_t offset(const std::array<size_t, N>& i) const noexcept{
+                size_t o = 0U;
+                for(size_t k = N; k > 0U; --k){
+                    o = o*extents_.extent(k-1U)+i[k-1U];
+                }
+                return o;
+            }
+            template<typename F>
+            constexpr void for_each_index(F&& f) const{
+                detail::for_each_index(std::array<size_t, N>{}, extents_.array(), order, f);
+            }
+            friend constexpr bool operator==(const mapping&, const mapping&) noexcept = default;
+            //----------------------------------------------------------------------------------------------------------
+        };
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Tiled (blocked) layout: BxBx... tiles stored contiguously (row-major within each tile), tiles stored in
+    //!        row-major order.
+    //! @note  Example: vla::mdarray<double, vla::extents<vla::dyn, vla::dyn, vla::dyn>, vla::layout_tiled<8>> a(n, n, n)
+    //!        Neighbours along any dimension are at most a tile away, so that sweeps along the outermost dimension
+    //!        touch B times fewer cache lines/pages than in the row-major layout. Each extent is rounded up to a
+    //!        multiple of B (the padding elements are constructed but never addressed by an index).
+    //!
+    template<size_t B = 8U>
+    struct layout_tiled{
+        static_assert(B > 0U, "layout_tiled<B>: B must be positive.");
+        template<typename E>
+        class mapping{
+        private:
+            static constexpr size_t N = E::rank();    //!<Rank.
+            static constexpr size_t V = [](){         //!<Tile volume (B^N).
+                size_t v = 1U;
+                for(size_t k = 0U; k < N; ++k){
+                    v *= B;
+                }
+                return v;
+            }();
+            E extents_;                               //!<Extents.
+        public:
+            static constexpr bool                  is_strided = false;                          //!<Strided (view).
+            static constexpr std::array<size_t, N> order      = detail::order<N>(false);        //!<Dimension order.
+            //----------------------------------------------------------------------------------------------------------
+            constexpr mapping() noexcept = default;
+            constexpr explicit mapping(const E& extents) noexcept : extents_(extents){
+            }
+            constexpr const E& extents() const noexcept{
+                return extents_;
+            }
+            constexpr size_t span() const noexcept{
+                size_t s = 1U;
+                for(size_t k = 0U; k < N; ++k){
+                    s *= tiles(k)*B;
+                }
+                return s;
+            }
+            template<typename ... Idx> requires(sizeof ... (Idx) == N)
+            constexpr size_t operator()(Idx ... i) const noexcept{
+                return offset({detail::index(i)...});
+            }
+            constexpr size_t offset(const std::array<size_t, N>& i) const noexcept{
+                size_t t = 0U, o = 0U;
+                for(size_t k = 0U; k < N; ++k){
+                    t = t*tiles(k)+i[k]/B;
+                    o = o*B+i[k]%B;
+                }
+                return t*V+o;
+            }
+            template<typename F>
+            constexpr void for_each_index(F&& f) const{
+                std::array<size_t, N> m{};
+                for(size_t k = 0U; k < N; ++k){
+                    m[k] = tiles(k);
+                }
+                detail::for_each_index(std::array<size_t, N>{}, m, order, [&](const std::array<size_t, N>& t){
+                    std::array<size_t, N> first{}, last{};
+                    for(size_t k = 0U; k < N; ++k){
+                        first[k] = t[k]*B;
+                        last[k]  = std::min(first[k]+B, extents_.extent(k));
+                    }
+                    detail::for_each_index(first, last, order, f);
+                });
+            }
+            friend constexpr bool operator==(const mapping&, const mapping&) noexcept = default;
+            //----------------------------------------------------------------------------------------------------------
+        private:
+            constexpr size_t tiles(size_t k) const noexcept{
+                return (extents_.extent(k)+B-1U)/B;
+            }
+            //----------------------------------------------------------------------------------------------------------
+        };
+    };
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,487 @@
+/**
+ * @file    MdArray.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   N-D (dynamic) array template w/ mixed compile-time/run-time extents.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_MDARRAY_H
+#define DYNARRAY_MDARRAY_H
+
+#include<algorithm>
+#include<array>
+#include<limits>
+#include<memory>
+#include<stdexcept>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+
+#include "Auxiliary.h"
+#include "DynArrayView.h"
+#include "Expression.h"
+#include "Extents.h"
+#include "Layout.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief N-D (dynamic) array template w/ mixed compile-time/run-time extents E = vla::extents<E(0), E(1), ...>
+    //!        and layout policy L (see Layout.h).
+    //! @note  Example: vla::mdarray<double, vla::extents<vla::dyn, 3>> a(n) : nx3-element array (3-component vectors).
+    //!        By default, same (contiguous, row-major) layout as vla::dynarray<T, N, A>, but only the dynamic extents
+    //!        are stored: strides and offsets of static dimensions are compile-time constants, e.g.
+    //!        a(i, j) = *(a.data()+3*i+j), so that loops over them unroll (and vectorise) w/o loading strides.
+    //!
+    template<typename T, typename E, typename L = layout_right, template<typename U> typename A = std::allocator>
+    class mdarray{
+        static_assert(detail::is_extents_v<E>, "mdarray<T, E, L, A>: E must be an extents<E ...>.");
+        static_assert(detail::padding<A<T>>() == 1U, "mdarray<T, E, L, A>: padded allocators are not supported.");
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using       type_v =       T;                                  //!<         Type value      alias.
+        using const_type_v = const T;                                  //!<Constant type value      alias.
+        using       type_p =       type_v*;                            //!<         Type pointer    alias.
+        using const_type_p = const type_v*;                            //!<Constant type pointer    alias.
+        using       type_r =       type_v&;                            //!<         Type reference  alias.
+        using const_type_r = const type_v&;                            //!<Constant type reference  alias.
+        using       type_a =     A<type_v>;                            //!<         Type allocator  alias.
+        using       TYPE_E =       std::array<size_t, E::rank()>;      //!<         Type extents    alias.
+        using       TYPE_M = typename L::template mapping<E>;          //!<         Type mapping    alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary constants.
+        //!
+        static constexpr size_t N = E::rank();         //!<Rank.
+        static constexpr size_t D = E::rank_dynamic(); //!<Dynamic rank.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        size_t size_;      //!<Type              size.      //!<n(0)*n(1)*n(2)*...
+        size_t span_;      //!<Type              span.      //!<>= size_ (if padded, e.g. layout_tiled<B>).
+        type_a allocator_; //!<Type              allocator.
+        type_p data_;      //!<Type (pointer to) data.
+        TYPE_M mapping_;   //!<Type              mapping.   //!<Dynamic extents only.
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::mdarray<int, vla::extents<vla::dyn, 3>> a : 0x3-element (empty) array.
+        //!                 vla::mdarray<int, vla::extents<2, 3>>        a : 2x3-element (integer) array filled w/ 0's.
+        //!
+        mdarray() : mdarray(E{}){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::mdarray<int, vla::extents<vla::dyn, 3>> a(4U)    : 4x3-element array filled w/ 0's.
+        //!                 vla::mdarray<int, vla::extents<vla::dyn, 3>> a(4U, 5) : 4x3-element array filled w/ 5's.
+        //!                 vla::mdarray<int, vla::extents<2, 3>>        a(e, 5)  : idem, w/ extents e.
+        //!        The first rank_dynamic() arguments are the dynamic extents, the remaining ones are forwarded to each
+        //!        element's constructor.
+        //!
+        template<typename ... Args>
+        explicit mdarray(const E& extents, const Args& ... args) : size_(extents.size()), data_(nullptr),
+                                                                   mapping_(extents){
+            span_ = size_ == 0U ? 0U : mapping_.span();
+            if(span_ != 0U){
+                if(span_ >= max_size()){
+                    throw std::invalid_argument("mdarray<T, E, L, A>::mdarray(const E&, const Args& ...)");
+                }
+                // Initialise...
+                data_ = allocator_.allocate(span_);
+                try{
+                    // Construct...
+                    detail::construct_n(allocator_, data_, span_, args...);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, span_);
+                    throw;
+                }
+            }
+        }
+        template<typename ... Args> requires(D > 0U && 1U+sizeof ... (Args) >= D)
+        explicit mdarray(size_t n, const Args& ... args) : mdarray(std::forward_as_tuple(n, args...),
+                                                                   std::make_index_sequence<D>{},
+                                                                   std::make_index_sequence<1U+sizeof ... (Args)-D>{}){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy constructor (deep copy).
+        //!
+        mdarray(const mdarray& other) :
+            size_(other.size_), span_(other.span_),
+            allocator_(std::allocator_traits<type_a>::select_on_container_copy_construction(other.allocator_)),
+            data_(nullptr), mapping_(other.mapping_){
+            if(span_ != 0U){
+                // Initialise...
+                data_ = allocator_.allocate(span_);
+                try{
+                    // Construct...
+                    detail::copy_n(allocator_, other.data_, span_, data_);
+                }
+                catch(...){
+                    allocator_.deallocate(data_, span_);
+                    throw;
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Move constructor.
+        //!
+        mdarray(mdarray&& other) noexcept : size_(0U), span_(0U), data_(nullptr), mapping_{}{
+            swap(*this, other);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy/move assignment (calls copy/move constructor).
+        //!
+        mdarray& operator=(mdarray other) noexcept{
+            swap(*this, other);
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Expression assignment (single fused pass, no temporaries). See expression<E> (Expression.h).
+        //!
+        template<typename X> requires(TYPE_M::is_strided)
+        mdarray& operator=(const expression<X>& e){
+            view() = e;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<mdarray, X>)
+        mdarray& operator+=(const X& x){
+            view() += x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<mdarray, X>)
+        mdarray& operator-=(const X& x){
+            view() -= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<mdarray, X>)
+        mdarray& operator*=(const X& x){
+            view() *= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<mdarray, X>)
+        mdarray& operator/=(const X& x){
+            view() /= x;
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor.
+        //!
+        ~mdarray() noexcept{
+            if(data_ != nullptr){
+                detail::destroy_n(allocator_, data_, span_);
+                allocator_.deallocate(data_, span_);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: at.
+        //!                        operator[].
+        //!                        operator().
+        //!                        data.
+        //! @note  operator[] returns the (non-owning) view of array block i (run-time strides), e.g. a[i][j], and is
+        //!        only available for strided layouts. Prefer operator()(i, j, k, ...) in hot loops: the offset is
+        //!        computed w/ the static extents.
+        //!
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        type_r at(Idx ... idx){
+            if(!in_range(std::make_index_sequence<N>{}, idx...)){
+                throw std::out_of_range("mdarray<T, E, L, A>::at(Idx ...)");
+            }
+            return (*this)(idx...);
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_type_r at(Idx ... idx) const{
+            if(!in_range(std::make_index_sequence<N>{}, idx...)){
+                throw std::out_of_range("mdarray<T, E, L, A>::at(Idx ...) const");
+            }
+            return (*this)(idx...);
+        }
+        decltype(auto) operator[](size_t i) noexcept requires(N == 1U || TYPE_M::is_strided){
+            if constexpr(N == 1U){
+                return *(data_+mapping_(i));
+            }
+            else{
+                return view().slice(0U, i);
+            }
+        }
+        decltype(auto) operator[](size_t i) const noexcept requires(N == 1U || TYPE_M::is_strided){
+            if constexpr(N == 1U){
+                return *(data_+mapping_(i));
+            }
+            else{
+                return view().slice(0U, i);
+            }
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        type_r operator()(Idx ... idx) noexcept{
+            return *(data_+mapping_(idx...));
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_type_r operator()(Idx ... idx) const noexcept{
+            return *(data_+mapping_(idx...));
+        }
+        type_p data() noexcept{
+            return data_;
+        }
+        const_type_p data() const noexcept{
+            return data_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Iterators: begin.
+        //!                   end.
+        //! @note  [begin(), end()) is the storage in memory order (incl. padding elements, e.g. for layout_tiled<B>).
+        //!        Use for_each(f) to visit the elements only.
+        //!
+        type_p begin() noexcept{
+            return data_;
+        }
+        const_type_p begin() const noexcept{
+            return data_;
+        }
+        type_p end() noexcept{
+            return data_+span_;
+        }
+        const_type_p end() const noexcept{
+            return data_+span_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: empty.
+        //!                  size.
+        //!                  span.
+        //!                  max_size.
+        //!                  rank.
+        //!                  rank_dynamic.
+        //!                  static_extent.
+        //!                  extent.
+        //!                  extents.
+        //!                  shape (extents<E ...>).
+        //!                  mapping.
+        //!                  stride (strided layouts only).
+        //!                  is_contiguous.
+        //!
+        bool empty() const noexcept{
+            return size_ == 0U;
+        }
+        size_t size() const noexcept{
+            return size_;
+        }
+        size_t span() const noexcept{
+            return span_;
+        }
+        size_t max_size() const noexcept{
+            return static_cast<size_t>(std::numeric_limits<size_d>::max());
+        }
+        static constexpr size_t rank() noexcept{
+            return N;
+        }
+        static constexpr size_t rank_dynamic() noexcept{
+            return D;
+        }
+        static constexpr size_t static_extent(size_t k) noexcept{
+            return E::static_extent(k);
+        }
+        template<size_t K>
+        size_t extent() const noexcept{
+            return shape().template extent<K>();
+        }
+        size_t extent(size_t k) const noexcept{
+            return shape().extent(k);
+        }
+        TYPE_E extents() const noexcept{
+            return shape().array();
+        }
+        const E& shape() const noexcept{
+            return mapping_.extents();
+        }
+        const TYPE_M& mapping() const noexcept{
+            return mapping_;
+        }
+        template<size_t K> requires(TYPE_M::is_strided)
+        size_t stride() const noexcept{
+            if constexpr(std::is_same_v<L, layout_right>){
+                return shape().template stride<K>();
+            }
+            else{
+                return mapping_.stride(K);
+            }
+        }
+        size_t stride(size_t k) const noexcept requires(TYPE_M::is_strided){
+            return mapping_.stride(k);
+        }
+        bool is_contiguous() const noexcept{
+            return std::is_same_v<L, layout_right>;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory footprint: payload_bytes.
+        //!                          metadata_bytes.
+        //!                          allocation_count.
+        //! @note  payload_bytes() is the size of the allocated storage (incl. padding, see span), metadata_bytes() the
+        //!        size of the array object itself (dynamic extents, pointer and allocator).
+        //!        allocation_count() is only available w/ a counting allocator (see vla::counting_allocator).
+        //!
+        size_t payload_bytes() const noexcept{
+            return span_*sizeof(T);
+        }
+        size_t metadata_bytes() const noexcept{
+            return sizeof(mdarray);
+        }
+        size_t allocation_count() const noexcept requires(requires(const type_a& a){a.allocation_count();}){
+            return allocator_.allocation_count();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Views: view (run-time extents and strides, see dynarray_view<T, N>; strided layouts only).
+        //!
+        dynarray_view<T, N> view() noexcept requires(TYPE_M::is_strided){
+            return dynarray_view<T, N>(data_, extents(), strides());
+        }
+        dynarray_view<const T, N> view() const noexcept requires(TYPE_M::is_strided){
+            return dynarray_view<const T, N>(data_, extents(), strides());
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: for_each (in memory order).
+        //!                    fill.
+        //!                    swap.
+        //!                    get_allocator.
+        //!
+        template<typename F>
+        void for_each(F f){
+            if constexpr(TYPE_M::is_strided){
+                for(size_t i = 0U; i < size_; ++i){
+                    f(data_[i]);
+                }
+            }
+            else{
+                mapping_.for_each_index([&](const TYPE_E& i){f(data_[mapping_.offset(i)]);});
+            }
+        }
+        template<typename F>
+        void for_each(F f) const{
+            if constexpr(TYPE_M::is_strided){
+                for(size_t i = 0U; i < size_; ++i){
+                    f(std::as_const(data_[i]));
+                }
+            }
+            else{
+                mapping_.for_each_index([&](const TYPE_E& i){f(std::as_const(data_[mapping_.offset(i)]));});
+            }
+        }
+        void fill(const_type_v& value){
+            detail::fill_n(data_, span_, value);
+        }
+        friend void swap(mdarray& lhs, mdarray& rhs) noexcept{
+            std::swap(lhs.allocator_, rhs.allocator_);
+            std::swap(lhs.data_, rhs.data_);
+            std::swap(lhs.size_, rhs.size_);
+            std::swap(lhs.span_, rhs.span_);
+            std::swap(lhs.mapping_, rhs.mapping_);
+        }
+        type_a get_allocator() const noexcept{
+            return allocator_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator== .
+        //!                              operator!= .
+        //!
+        friend bool operator==(const mdarray& lhs, const mdarray& rhs){
+            if(lhs.mapping_ != rhs.mapping_){
+                return false;
+            }
+            bool equal = true;
+            lhs.mapping_.for_each_index([&](const TYPE_E& i){
+                const size_t o = lhs.mapping_.offset(i);
+                equal = equal && lhs.data_[o] == rhs.data_[o];
+            });
+            return equal;
+        }
+        friend bool operator!=(const mdarray& lhs, const mdarray& rhs){
+            return !(lhs == rhs);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (split the (input) arguments into dynamic extents and element arguments).
+        //!
+        template<typename Tuple, size_t ... I, size_t ... J>
+        mdarray(const Tuple& args, std::index_sequence<I ...>, std::index_sequence<J ...>) :
+            mdarray(E(std::get<I>(args)...), std::get<D+J>(args)...){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether element (i(0), i(1), ...) is within bounds.
+        //!
+        template<size_t ... K, typename ... Idx>
+        bool in_range(std::index_sequence<K ...>, Idx ... idx) const noexcept{
+            return ((detail::index(idx) < shape().template extent<K>()) && ...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Strides (strided layouts only).
+        //!
+        TYPE_E strides() const noexcept{
+            TYPE_E s{};
+            for(size_t k = 0U; k < N; ++k){
+                s[k] = mapping_.stride(k);
+            }
+            return s;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Layout conversion: copy of array a w/ layout L2.
+    //! @note  Example: auto b = vla::relayout<vla::layout_left>(a) : column-major copy of (row-major) array a.
+    //!        The index space is swept in BxBx... blocks (in the memory order of L2), so that both the source and the
+    //!        destination are accessed w/ cache-line reuse even when their fastest dimensions differ (e.g. transpose).
+    //!        T must be default-constructible and copy-assignable.
+    //!
+    template<typename L2, size_t B = 16U, typename T, typename E, typename L, template<typename> typename A>
+    mdarray<T, E, L2, A> relayout(const mdarray<T, E, L, A>& a){
+        constexpr size_t N     = E::rank();
+        constexpr auto   order = L2::template mapping<E>::order;
+
+        mdarray<T, E, L2, A> b(a.shape());
+        std::array<size_t, N> m{};
+        for(size_t k = 0U; k < N; ++k){
+            m[k] = (a.extent(k)+B-1U)/B;
+        }
+        detail::for_each_index(std::array<size_t, N>{}, m, order, [&](const std::array<size_t, N>& t){
+            std::array<size_t, N> first{}, last{};
+            for(size_t k = 0U; k < N; ++k){
+                first[k] = t[k]*B;
+                last[k]  = std::min(first[k]+B, a.extent(k));
+            }
+            detail::for_each_index(first, last, order, [&](const std::array<size_t, N>& i){
+                b.data()[b.mapping().offset(i)] = a.data()[a.mapping().offset(i)];
+            });
+        });
+        return b;
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file    Numa.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   NUMA page placement queries for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_NUMA_H
+#define DYNARRAY_NUMA_H
+
+#include<algorithm>
+#include<bit>
+#include<cstdint>
+#include<filesystem>
+#include<ostream>
+#include<string>
+#include<vector>
+
+#if defined(__linux__)
+#include<sys/syscall.h>
+#include<unistd.h>
+#endif
+
+#include "Auxiliary.h"
+
+namespace vla::numa{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Page placement of a memory range.
+    //! @note  pages[k] is the number of resident pages on node k. Pages that were never touched (or whose node cannot
+    //!        be queried, e.g. on non-Linux systems or if move_pages is not permitted) are counted as absent.
+    //!
+    struct placement{
+        std::vector<size_t> pages;  //!<Resident pages (per node).
+        size_t              absent; //!<Absent   pages.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: size (total number of pages).
+        //!
+        size_t size() const noexcept{
+            size_t n = absent;
+            for(auto k : pages){
+                n += k;
+            }
+            return n;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator<< .
+        //! @note  Example: std::cout << vla::numa::pages(a) : "node 0: 512 pages (50%), node 1: 512 pages (50%)".
+        //!
+        friend std::ostream& operator<<(std::ostream& os, const placement& p){
+            const size_t n = std::max<size_t>(p.size(), 1U);
+            for(size_t k = 0U; k < p.pages.size(); ++k){
+                os << "node " << k << ": " << p.pages[k] << " pages (" << 100U*p.pages[k]/n << "%), ";
+            }
+            return os << "absent: " << p.absent << " pages (" << 100U*p.absent/n << "%)";
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Number of NUMA nodes (1 if it cannot be queried).
+    //!
+    inline size_t nodes(){
+        size_t n = 0U;
+        std::error_code ec;
+        for(const auto& e : std::filesystem::directory_iterator("/sys/devices/system/node", ec)){
+            const std::string name = e.path().filename().string();
+            if(name.size() > 4U && name.starts_with("node") &&
+               std::all_of(name.begin()+4, name.end(), [](char c){return c >= '0' && c <= '9';})){
+                ++n;
+            }
+        }
+        return std::max<size_t>(n, 1U);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Page size (bytes).
+    //!
+    inline size_t page_size() noexcept{
+#if defined(__linux__)
+        const long n = sysconf(_SC_PAGESIZE);
+        return n > 0 ? vla::detail::index(n) : 4096U;
+#else
+        return 4096U;
+#endif
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Page placement of bytes [p, p+n).
+    //! @note  Example: vla::numa::pages(a.data(), 1024U)
+    //!                 vla::numa::pages(a) : pages spanned by array/view a (incl. padding and gaps).
+    //!        Pages are queried w/ move_pages(2) (no page is moved).
+    //!
+    inline placement pages(const void* p, size_t n){
+        placement q{std::vector<size_t>(nodes(), 0U), 0U};
+        if(p == nullptr || n == 0U){
+            return q;
+        }
+        const size_t s = page_size();
+        const auto   first = std::bit_cast<std::uintptr_t>(p)/s*s;
+        const auto   last  = (std::bit_cast<std::uintptr_t>(p)+n-1U)/s*s;
+        const size_t count = (last-first)/s+1U;
+#if defined(__linux__) && defined(SYS_move_pages)
+        constexpr size_t batch = 1024U;
+        std::vector<void*> addresses(batch);
+        std::vector<int>   status(batch);
+        for(size_t i = 0U; i < count; i += batch){
+            const size_t m = std::min(batch, count-i);
+            for(size_t j = 0U; j < m; ++j){
+                addresses[j] = std::bit_cast<void*>(first+(i+j)*s);
+            }
+            if(syscall(SYS_move_pages, 0, m, addresses.data(), nullptr, status.data(), 0) != 0){
+                q.absent += count-i;
+                break;
+            }
+            for(size_t j = 0U; j < m; ++j){
+                if(status[j] < 0){
+                    ++q.absent;
+                }
+                else{
+                    const size_t k = vla::detail::index(status[j]);
+                    if(k >= q.pages.size()){
+                        q.pages.resize(k+1U, 0U);
+                    }
+                    ++q.pages[k];
+                }
+            }
+        }
+#else
+        q.absent = count;
+#endif
+        return q;
+    }
+    template<typename X>
+    placement pages(const X& x){
+        if(x.empty()){
+            return pages(nullptr, 0U);
+        }
+        size_t n = 1U;
+        for(size_t k = 0U; k < x.extents().size(); ++k){
+            n += (x.extent(k)-1U)*x.stride(k);
+        }
+        return pages(x.data(), n*sizeof(*x.data()));
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,595 @@
+/**
+ * @file    Numeric.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Vectorised reductions and BLAS-1 kernels (runtime ISA dispatch) for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_NUMERIC_H
+#define DYNARRAY_NUMERIC_H
+
+#include<algorithm>
+#include<atomic>
+#include<cmath>
+#include<cstring>
+#include<stdexcept>
+#include<type_traits>
+
+#include "Auxiliary.h"
+#include "DynArrayView.h"
+
+namespace vla::numeric{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Instruction set of the vectorised kernels.
+    //! @note  baseline : the compiler's target (SSE2 on x86-64, NEON on AArch64, scalar otherwise).
+    //!        avx2     : 256-bit vectors (x86 only, selected at runtime if the CPU and OS support it).
+    //!        avx512   : 512-bit vectors (idem).
+    //!
+    enum class isa{
+        baseline,
+        avx2,
+        avx512
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Best instruction set supported by the CPU (and OS), and the one currently selected.
+        //!
+        inline isa detect() noexcept{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx512f")){
+                return isa::avx512;
+            }
+            if(__builtin_cpu_supports("avx2")){
+                return isa::avx2;
+            }
+#endif
+            return isa::baseline;
+        }
+        inline std::atomic<isa>& selected() noexcept{
+            static std::atomic<isa> s{detect()};
+            return s;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Vector of lanes<T> elements (128 bytes: 2 AVX-512, 4 AVX2 or 8 SSE2 registers, i.e. independent
+        //!        accumulators), and whether T is vectorised.
+        //! @note  Every instruction set runs the same operations on the same lanes in the same order, hence results
+        //!        of sums, minima/maxima and their indices are bitwise identical whichever instruction set is selected.
+        //!        Vector kernels need GCC/Clang vector extensions; other compilers run the scalar kernels below.
+        //!
+        template<typename T>
+        inline constexpr size_t lanes = 128U/sizeof(T);
+        template<typename T>
+        inline constexpr bool is_simd_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8U;
+#if defined(__GNUC__)
+        template<typename T>
+        struct vector{
+            using type [[gnu::vector_size(128)]] = T;
+        };
+        template<typename T>
+        using vec = typename vector<T>::type;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Unaligned vector load/store, absolute value and horizontal fold (fixed pairwise order).
+        //!
+        template<typename T>
+        [[gnu::always_inline]] inline vec<T> load(const T* p) noexcept{
+            vec<T> v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        template<typename T>
+        [[gnu::always_inline]] inline void store(T* p, const vec<T>& v) noexcept{
+            std::memcpy(p, &v, sizeof(v));
+        }
+        template<typename T>
+        [[gnu::always_inline]] inline vec<T> abs(const vec<T>& v) noexcept{
+            return v < 0 ? -v : v;
+        }
+        template<typename T, typename F>
+        [[gnu::always_inline]] inline T fold(const vec<T>& v, F f) noexcept{
+            T a[lanes<T>];
+            std::memcpy(a, &v, sizeof(v));
+            for(size_t w = lanes<T>/2U; w > 0U; w /= 2U){
+                for(size_t k = 0U; k < w; ++k){
+                    a[k] = f(a[k], a[k+w]);
+                }
+            }
+            return a[0U];
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Kernels (contiguous elements): sum       (sum of f(p[i])).
+        //!                                       kahan     (compensated sum, returns the sum and its compensation).
+        //!                                       extremum  (min (Max = false) or max (Max = true) of f(p[i]), n > 0).
+        //!                                       arg       (index of the first min/max, n > 0).
+        //!                                       dot       (sum of p[i]*q[i]).
+        //!                                       axpy      (q[i] += a*p[i]).
+        //!
+        template<typename T, bool Abs = false>
+        struct sum{
+            [[gnu::always_inline]] static T run(const T* p, size_t n) noexcept{
+                constexpr size_t L = lanes<T>;
+                vec<T> acc{};
+                size_t i = 0U;
+                for(; i+L <= n; i += L){
+                    if constexpr(Abs){
+                        acc += detail::abs<T>(load(p+i));
+                    }
+                    else{
+                        acc += load(p+i);
+                    }
+                }
+                T s = fold<T>(acc, [](T x, T y){return x+y;});
+                for(; i < n; ++i){
+                    s += Abs ? (p[i] < 0 ? -p[i] : p[i]) : p[i];
+                }
+                return s;
+            }
+        };
+        template<typename T>
+        struct kahan{
+            [[gnu::always_inline]] static void run(const T* p, size_t n, T* s, T* c) noexcept{
+                constexpr size_t L = lanes<T>;
+                vec<T> vs{}, vc{};
+                size_t i = 0U;
+                for(; i+L <= n; i += L){
+                    const vec<T> y = load(p+i)-vc;
+                    const vec<T> t = vs+y;
+                    vc = (t-vs)-y;
+                    vs = t;
+                }
+                T a[L], b[L];
+                std::memcpy(a, &vs, sizeof(vs));
+                std::memcpy(b, &vc, sizeof(vc));
+                for(size_t k = 0U; k < L; ++k){
+                    add(*s, *c, a[k]);
+                    add(*s, *c, -b[k]);
+                }
+                for(; i < n; ++i){
+                    add(*s, *c, p[i]);
+                }
+            }
+            [[gnu::always_inline]] static void add(T& s, T& c, T x) noexcept{
+                const T y = x-c;
+                const T t = s+y;
+                c = (t-s)-y;
+                s = t;
+            }
+        };
+        template<typename T, bool Max, bool Abs = false>
+        struct extremum{
+            [[gnu::always_inline]] static T run(const T* p, size_t n) noexcept{
+                constexpr size_t L = lanes<T>;
+                const auto f = [](T x){return Abs && x < 0 ? -x : x;};
+                const auto g = [](T x, T y){return Max ? (y > x ? y : x) : (y < x ? y : x);};
+                T m = f(p[0U]);
+                size_t i = 0U;
+                if(n >= L){
+                    vec<T> acc = Abs ? detail::abs<T>(load(p)) : load(p);
+                    for(i = L; i+L <= n; i += L){
+                        const vec<T> v = Abs ? detail::abs<T>(load(p+i)) : load(p+i);
+                        acc = Max ? (v > acc ? v : acc) : (v < acc ? v : acc);
+                    }
+                    m = fold<T>(acc, g);
+                }
+                for(; i < n; ++i){
+                    m = g(m, f(p[i]));
+                }
+                return m;
+            }
+        };
+        template<typename T>
+        struct dot{
+            [[gnu::always_inline]] static T run(const T* p, const T* q, size_t n) noexcept{
+                constexpr size_t L = lanes<T>;
+                vec<T> acc{};
+                size_t i = 0U;
+                for(; i+L <= n; i += L){
+                    acc += load(p+i)*load(q+i);
+                }
+                T s = fold<T>(acc, [](T x, T y){return x+y;});
+                for(; i < n; ++i){
+                    s += p[i]*q[i];
+                }
+                return s;
+            }
+        };
+        template<typename T>
+        struct axpy{
+            [[gnu::always_inline]] static void run(T a, const T* p, T* q, size_t n) noexcept{
+                constexpr size_t L = lanes<T>;
+                size_t i = 0U;
+                for(; i+L <= n; i += L){
+                    store(q+i, load(q+i)+a*load(p+i));
+                }
+                for(; i < n; ++i){
+                    q[i] += a*p[i];
+                }
+            }
+        };
+#else
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Kernels (scalar fallback, same interface).
+        //!
+        template<typename T, bool Abs = false>
+        struct sum{
+            static T run(const T* p, size_t n) noexcept{
+                T s{};
+                for(size_t i = 0U; i < n; ++i){
+                    s += Abs ? (p[i] < 0 ? -p[i] : p[i]) : p[i];
+                }
+                return s;
+            }
+        };
+        template<typename T>
+        struct kahan{
+            static void run(const T* p, size_t n, T* s, T* c) noexcept{
+                for(size_t i = 0U; i < n; ++i){
+                    add(*s, *c, p[i]);
+                }
+            }
+            static void add(T& s, T& c, T x) noexcept{
+                const T y = x-c;
+                const T t = s+y;
+                c = (t-s)-y;
+                s = t;
+            }
+        };
+        template<typename T, bool Max, bool Abs = false>
+        struct extremum{
+            static T run(const T* p, size_t n) noexcept{
+                const auto f = [](T x){return Abs && x < 0 ? -x : x;};
+                T m = f(p[0U]);
+                for(size_t i = 1U; i < n; ++i){
+                    m = Max ? (f(p[i]) > m ? f(p[i]) : m) : (f(p[i]) < m ? f(p[i]) : m);
+                }
+                return m;
+            }
+        };
+        template<typename T>
+        struct dot{
+            static T run(const T* p, const T* q, size_t n) noexcept{
+                T s{};
+                for(size_t i = 0U; i < n; ++i){
+                    s += p[i]*q[i];
+                }
+                return s;
+            }
+        };
+        template<typename T>
+        struct axpy{
+            static void run(T a, const T* p, T* q, size_t n) noexcept{
+                for(size_t i = 0U; i < n; ++i){
+                    q[i] += a*p[i];
+                }
+            }
+        };
+#endif
+        template<typename T, bool Max>
+        struct arg{
+            [[gnu::always_inline]] static size_t run(const T* p, size_t n) noexcept{
+                constexpr size_t B = 64U*lanes<T>;
+                size_t best = 0U;
+                T      m    = p[0U];
+                for(size_t first = 0U; first < n; first += B){
+                    const T x = extremum<T, Max>::run(p+first, std::min(B, n-first));
+                    if(Max ? x > m : x < m){
+                        m    = x;
+                        best = first;
+                    }
+                }
+                for(size_t i = best, last = std::min(best+B, n); i < last; ++i){
+                    if(p[i] == m){
+                        return i;
+                    }
+                }
+                return best;                                    //!<NaN m (e.g. p[0]): no element compares equal.
+            }
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Run kernel K w/ the selected instruction set.
+        //!
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        template<typename K, typename ... Args>
+        [[gnu::target("avx512f")]] auto run_avx512(Args ... args) noexcept{
+            return K::run(args...);
+        }
+        template<typename K, typename ... Args>
+        [[gnu::target("avx2")]] auto run_avx2(Args ... args) noexcept{
+            return K::run(args...);
+        }
+#endif
+        template<typename K, typename ... Args>
+        auto run(Args ... args) noexcept{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            switch(selected().load(std::memory_order_relaxed)){
+                case isa::avx512:
+                    return run_avx512<K>(args...);
+                case isa::avx2:
+                    return run_avx2<K>(args...);
+                default:
+                    break;
+            }
+#endif
+            return K::run(args...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Call f(n, s0, s...) for each row of views v0, v... (same extents), where s0, s... are strided rows
+        //!        (stride 1 if contiguous), see vla::detail::for_each_row.
+        //!
+        template<typename T>
+        vla::detail::strided<T> segment(T* p) noexcept{
+            return {p, 1U};
+        }
+        template<typename T>
+        vla::detail::strided<T> segment(const vla::detail::strided<T>& r) noexcept{
+            return r;
+        }
+        template<typename F, typename V0, typename ... V>
+        void for_each_segment(F&& f, const V0& v0, const V& ... v){
+            if(((v.extents() != v0.extents()) || ...)){
+                throw std::invalid_argument("vla::numeric::detail::for_each_segment(F&&, const V0&, const V& ...)");
+            }
+            vla::detail::for_each_row([&f](size_t n, auto ... r){
+                f(n, segment(r)...);
+            }, v0, v...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element type of array (view) X.
+        //!
+        template<typename X>
+        using value_t = std::remove_cv_t<std::remove_pointer_t<
+            decltype(vla::detail::view_of(std::declval<X&>()).data())
+        >>;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Sum of f(x) (Abs: f = |.|) and min/max of f(x) (with its row-major index) over array (view) x.
+        //!
+        template<bool Abs, typename X>
+        auto sum_of(const X& x){
+            using T = value_t<X>;
+            T s{};
+            for_each_segment([&s](size_t n, auto r){
+                if constexpr(is_simd_v<T>){
+                    if(r.stride == 1U){
+                        s += run<detail::sum<T, Abs>>(static_cast<const T*>(r.head), n);
+                        return;
+                    }
+                }
+                for(size_t j = 0U; j < n; ++j){
+                    s += Abs ? (r[j] < T{} ? -r[j] : r[j]) : r[j];
+                }
+            }, vla::detail::view_of(x));
+            return s;
+        }
+        template<bool Max, bool Abs, typename X>
+        auto extremum_of(const X& x, size_t* index, const char* what){
+            using T = value_t<X>;
+            const auto v = vla::detail::view_of(x);
+            if(v.empty()){
+                throw std::invalid_argument(what);
+            }
+            T      m{};
+            size_t i = 0U, base = 0U;
+            bool   first = true;
+            const auto update = [&](T y, size_t j){
+                if(first || (Max ? y > m : y < m)){
+                    m     = y;
+                    i     = base+j;
+                    first = false;
+                }
+            };
+            for_each_segment([&](size_t n, auto r){
+                if constexpr(is_simd_v<T>){
+                    if(r.stride == 1U){
+                        const T* p = r.head;
+                        if(index != nullptr && !Abs){
+                            const size_t j = run<arg<T, Max>>(p, n);
+                            update(p[j], j);
+                        }
+                        else{
+                            update(run<extremum<T, Max, Abs>>(p, n), 0U);
+                        }
+                        base += n;
+                        return;
+                    }
+                }
+                for(size_t j = 0U; j < n; ++j){
+                    update(Abs && r[j] < T{} ? -r[j] : r[j], j);
+                }
+                base += n;
+            }, v);
+            if(index != nullptr){
+                *index = i;
+            }
+            return m;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Instruction set: supported_isa (best one supported by the CPU).
+    //!                         current_isa   (the one used by the kernels, supported_isa() by default).
+    //!                         set_isa       (select i, capped to supported_isa(); returns the previous one).
+    //! @note  Example: vla::numeric::set_isa(vla::numeric::isa::baseline) : e.g. to compare against the SSE2 kernels.
+    //!
+    inline isa supported_isa() noexcept{
+        static const isa s = detail::detect();
+        return s;
+    }
+    inline isa current_isa() noexcept{
+        return detail::selected().load(std::memory_order_relaxed);
+    }
+    inline isa set_isa(isa i) noexcept{
+        return detail::selected().exchange(std::min(i, supported_isa()), std::memory_order_relaxed);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Reductions: sum          (lane-wise partial sums, error grows as O(n) in the worst case).
+    //!                    pairwise_sum (blocks of pairwise_block elements combined pairwise, error O(log n)).
+    //!                    kahan_sum    (compensated, error O(1), ~4x the flops of sum).
+    //!                    min.
+    //!                    max.
+    //!                    argmin       (row-major index of the first minimum).
+    //!                    argmax       (row-major index of the first maximum).
+    //! @note  Example: vla::numeric::sum(a)                      : whole array.
+    //!                 vla::numeric::sum(a.slice(0U, 0U, n, 2U)) : every other outermost index (strided view).
+    //!        x may be any array or view. Contiguous rows run the vectorised kernels of the selected instruction set,
+    //!        strided rows (innermost stride > 1) a scalar loop. The summation order only depends on the view's shape
+    //!        and strides (not on the instruction set), hence results are reproducible. min/max/argmin/argmax of
+    //!        empty arrays throw std::invalid_argument; NaNs are not handled (the result is unspecified).
+    //!
+    inline constexpr size_t pairwise_block = 1024U; //!<Elements.
+    template<typename X>
+    auto sum(const X& x){
+        return detail::sum_of<false>(x);
+    }
+    template<typename X>
+    auto pairwise_sum(const X& x){
+        using T = detail::value_t<X>;
+        T      stack[64U] = {};
+        size_t depth = 0U, count = 0U;
+        const auto push = [&](T s){
+            for(size_t c = ++count; (c & 1U) == 0U; c >>= 1U){
+                s = stack[--depth]+s;
+            }
+            stack[depth++] = s;
+        };
+        detail::for_each_segment([&](size_t n, auto r){
+            for(size_t first = 0U; first < n; first += pairwise_block){
+                const size_t m = std::min(pairwise_block, n-first);
+                T s{};
+                if constexpr(detail::is_simd_v<T>){
+                    if(r.stride == 1U){
+                        push(detail::run<detail::sum<T>>(static_cast<const T*>(r.head+first), m));
+                        continue;
+                    }
+                }
+                for(size_t j = first; j < first+m; ++j){
+                    s += r[j];
+                }
+                push(s);
+            }
+        }, vla::detail::view_of(x));
+        T s{};
+        while(depth > 0U){
+            s = stack[--depth]+s;
+        }
+        return s;
+    }
+    template<typename X>
+    auto kahan_sum(const X& x){
+        using T = detail::value_t<X>;
+        T s{}, c{};
+        detail::for_each_segment([&](size_t n, auto r){
+            if constexpr(detail::is_simd_v<T>){
+                if(r.stride == 1U){
+                    detail::run<detail::kahan<T>>(static_cast<const T*>(r.head), n, &s, &c);
+                    return;
+                }
+            }
+            for(size_t j = 0U; j < n; ++j){
+                const T y = r[j]-c;
+                const T t = s+y;
+                c = (t-s)-y;
+                s = t;
+            }
+        }, vla::detail::view_of(x));
+        return s;
+    }
+    template<typename X>
+    auto min(const X& x){
+        return detail::extremum_of<false, false>(x, nullptr, "vla::numeric::min(const X&)");
+    }
+    template<typename X>
+    auto max(const X& x){
+        return detail::extremum_of<true, false>(x, nullptr, "vla::numeric::max(const X&)");
+    }
+    template<typename X>
+    size_t argmin(const X& x){
+        size_t i = 0U;
+        detail::extremum_of<false, false>(x, &i, "vla::numeric::argmin(const X&)");
+        return i;
+    }
+    template<typename X>
+    size_t argmax(const X& x){
+        size_t i = 0U;
+        detail::extremum_of<true, false>(x, &i, "vla::numeric::argmax(const X&)");
+        return i;
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief BLAS-1: dot      (sum of x(i)*y(i)).
+    //!                axpy     (y(i) += a*x(i)).
+    //!                norm1    (sum of |x(i)|).
+    //!                norm2    (square root of dot(x, x), not scaled against overflow).
+    //!                norm_inf (max of |x(i)|, 0 if x is empty).
+    //! @note  Example: const double r = vla::numeric::norm2(residual) : convergence check.
+    //!                 vla::numeric::axpy(-alpha, p, r)                : r -= alpha*p.
+    //!        x and y must have the same extents (std::invalid_argument otherwise). Products may be fused (FMA) w/
+    //!        AVX-512, hence dot/norm2/axpy may differ in the last bits between instruction sets.
+    //!
+    template<typename X, typename Y>
+    auto dot(const X& x, const Y& y){
+        using T = detail::value_t<X>;
+        T s{};
+        detail::for_each_segment([&s](size_t n, auto r, auto q){
+            if constexpr(detail::is_simd_v<T> && std::is_same_v<T, detail::value_t<Y>>){
+                if(r.stride == 1U && q.stride == 1U){
+                    s += detail::run<detail::dot<T>>(static_cast<const T*>(r.head), static_cast<const T*>(q.head), n);
+                    return;
+                }
+            }
+            for(size_t j = 0U; j < n; ++j){
+                s += r[j]*q[j];
+            }
+        }, vla::detail::view_of(x), vla::detail::view_of(y));
+        return s;
+    }
+    template<typename S, typename X, typename Y>
+    void axpy(const S& a, const X& x, Y&& y){
+        using T = detail::value_t<Y>;
+        detail::for_each_segment([&a](size_t n, auto r, auto q){
+            if constexpr(detail::is_simd_v<T> && std::is_same_v<T, detail::value_t<X>>){
+                if(r.stride == 1U && q.stride == 1U){
+                    detail::run<detail::axpy<T>>(static_cast<T>(a), static_cast<const T*>(r.head), q.head, n);
+                    return;
+                }
+            }
+            for(size_t j = 0U; j < n; ++j){
+                q[j] += a*r[j];
+            }
+        }, vla::detail::view_of(x), vla::detail::view_of(y));
+    }
+    template<typename X>
+    auto norm1(const X& x){
+        return detail::sum_of<true>(x);
+    }
+    template<typename X>
+    auto norm2(const X& x){
+        return std::sqrt(dot(x, x));
+    }
+    template<typename X>
+    auto norm_inf(const X& x){
+        if(vla::detail::view_of(x).empty()){
+            return detail::value_t<X>{};
+        }
+        return detail::extremum_of<true, true>(x, nullptr, "vla::numeric::norm_inf(const X&)");
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,545 @@
+/**
+ * @file    Parallel.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Parallel (thread pool) algorithms for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_PARALLEL_H
+#define DYNARRAY_PARALLEL_H
+
+#include<algorithm>
+#include<array>
+#include<atomic>
+#include<deque>
+#include<exception>
+#include<functional>
+#include<memory>
+#include<mutex>
+#include<optional>
+#include<stdexcept>
+#include<thread>
+#include<vector>
+
+#if defined(__linux__)
+#include<pthread.h>
+#include<sched.h>
+#endif
+
+#include "Auxiliary.h"
+#include "DynArrayView.h"
+
+namespace vla::parallel{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Work-stealing thread pool.
+    //! @note  Each worker owns a task queue: it pops tasks from the back of its own queue (LIFO, cache-friendly) and,
+    //!        once empty, steals from the front of the other queues (FIFO, i.e. the largest pending ranges). Threads
+    //!        waiting on a parallel loop (including the caller) execute pending tasks rather than blocking, hence
+    //!        loops may be nested. Pinned tasks (see for_range(..., pinned)) are never stolen.
+    //!
+    class thread_pool{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using task_t = std::function<void()>; //!<Task alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Task queue.
+        //!
+        struct queue{
+            std::mutex         mutex_;
+            std::deque<task_t> tasks_;
+            std::deque<task_t> pinned_;
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        std::unique_ptr<queue[]> queues_;  //!<Task queue (per worker).
+        std::vector<std::thread> threads_; //!<Workers.
+        std::atomic<size_t>      pending_; //!<Number of queued tasks.
+        std::atomic<size_t>      next_;    //!<Next queue (tasks submitted by non-workers).
+        std::atomic<size_t>      signal_;  //!<Wake-up counter (incremented on submit/stop).
+        std::atomic<bool>        stop_;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Current thread's pool/worker index (if it is a worker).
+        //!
+        inline static thread_local thread_pool* owner_ = nullptr;
+        inline static thread_local size_t       index_ = 0U;
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::parallel::thread_pool p(8U)       : 8 workers.
+        //!                 vla::parallel::thread_pool p(8U, true) : 8 workers, worker i bound to (allowed) CPU i.
+        //!        Binding workers to CPUs keeps pinned chunks, hence the pages they first touched, on the same NUMA node.
+        //!
+        explicit thread_pool(size_t n = std::max(1U, std::thread::hardware_concurrency()), bool bind = false) :
+            queues_(new queue[n]), pending_(0U), next_(0U), signal_(0U), stop_(false){
+            threads_.reserve(n);
+            for(size_t i = 0U; i < n; ++i){
+                threads_.emplace_back([this, i, bind](){
+                    owner_ = this;
+                    index_ = i;
+                    if(bind){
+                        bind_to(i);
+                    }
+                    work();
+                });
+            }
+        }
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor (pending tasks are completed first).
+        //!
+        ~thread_pool() noexcept{
+            stop_ = true;
+            ++signal_;
+            signal_.notify_all();
+            for(auto& t : threads_){
+                t.join();
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: size.
+        //!                  worker (index of the calling worker, size() if the caller is not one of its workers).
+        //!
+        size_t size() const noexcept{
+            return threads_.size();
+        }
+        size_t worker() const noexcept{
+            return owner_ == this ? index_ : size();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: submit.
+        //!                    run_one.
+        //!                    for_range.
+        //! @note  submit(f, i) pins f to worker i. A pool w/o workers (size() == 0) runs f on the calling thread.
+        //!
+        template<typename F>
+        void submit(F&& f){
+            if(size() == 0U){
+                f();
+                return;
+            }
+            const size_t i = owner_ == this ? index_ : next_++%size();
+            {
+                std::lock_guard<std::mutex> lock(queues_[i].mutex_);
+                queues_[i].tasks_.emplace_back(std::forward<F>(f));
+            }
+            ++pending_;
+            ++signal_;
+            signal_.notify_one();
+        }
+        template<typename F>
+        void submit(F&& f, size_t i){
+            if(size() == 0U){
+                f();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queues_[i%size()].mutex_);
+                queues_[i%size()].pinned_.emplace_back(std::forward<F>(f));
+            }
+            ++pending_;
+            ++signal_;
+            signal_.notify_all();
+        }
+        bool run_one(){
+            task_t task;
+            if(!pop(task)){
+                return false;
+            }
+            task();
+            return true;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Call f(first, last) on chunks [first, last) of [0, n) w/ at most grain indices each.
+        //! @note  Chunk boundaries only depend on n and grain, i.e. not on the number of workers nor on scheduling. The
+        //!        range is split recursively (in halves); idle workers steal the pending halves. If pinned, worker k
+        //!        runs the k-th contiguous block of chunks instead, hence every loop w/ the same n and grain maps chunk c
+        //!        to the same worker (static schedule). The first exception thrown by f is rethrown once every chunk
+        //!        has completed.
+        //!
+        template<typename F>
+        void for_range(size_t n, size_t grain, F&& f, bool pinned = false){
+            grain = std::max<size_t>(grain, 1U);
+            const size_t chunks = (n+grain-1U)/grain;
+            if(chunks <= 1U || size() == 0U){
+                for(size_t c = 0U; c < chunks; ++c){
+                    f(c*grain, std::min(n, (c+1U)*grain));
+                }
+                return;
+            }
+            struct state{
+                std::atomic<size_t> remaining;
+                std::exception_ptr  error;
+                std::mutex          mutex;
+            } s;
+            s.remaining = chunks;
+
+            auto run = [&](size_t c){
+                try{
+                    f(c*grain, std::min(n, (c+1U)*grain));
+                }
+                catch(...){
+                    std::lock_guard<std::mutex> lock(s.mutex);
+                    if(!s.error){
+                        s.error = std::current_exception();
+                    }
+                }
+                --s.remaining;
+            };
+            auto split = [&, this](auto&& self, size_t lo, size_t hi) -> void{
+                while(hi-lo > 1U){
+                    const size_t mid = lo+(hi-lo)/2U;
+                    submit([&self, mid, hi](){self(self, mid, hi);});
+                    hi = mid;
+                }
+                run(lo);
+            };
+            if(pinned){
+                for(size_t k = 0U; k < size(); ++k){
+                    const size_t lo = chunks*k/size(), hi = chunks*(k+1U)/size();
+                    if(lo < hi){
+                        submit([&run, lo, hi](){
+                            for(size_t c = lo; c < hi; ++c){
+                                run(c);
+                            }
+                        }, k);
+                    }
+                }
+            }
+            else{
+                split(split, 0U, chunks);
+            }
+            while(s.remaining > 0U){
+                if(!run_one()){
+                    std::this_thread::yield();
+                }
+            }
+            if(s.error){
+                std::rethrow_exception(s.error);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Bind the calling thread to the i-th CPU of its affinity mask (no-op if unsupported).
+        //!
+        static void bind_to(size_t i) noexcept{
+#if defined(__linux__)
+            cpu_set_t set;
+            if(sched_getaffinity(0, sizeof(set), &set) != 0 || CPU_COUNT(&set) == 0){
+                return;
+            }
+            i %= vla::detail::index(CPU_COUNT(&set));
+            for(size_t cpu = 0U; cpu < vla::detail::index(CPU_SETSIZE); ++cpu){
+                if(CPU_ISSET(cpu, &set) && i-- == 0U){
+                    CPU_ZERO(&set);
+                    CPU_SET(cpu, &set);
+                    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+                    return;
+                }
+            }
+#else
+            static_cast<void>(i);
+#endif
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Pop task from own queues (pinned first, back) or steal it from another queue (front).
+        //!
+        bool pop(task_t& task){
+            if(pending_ == 0U){
+                return false;
+            }
+            const size_t n = size();
+            const size_t i = owner_ == this ? index_ : 0U;
+            if(owner_ == this){
+                std::lock_guard<std::mutex> lock(queues_[i].mutex_);
+                if(!queues_[i].pinned_.empty()){
+                    task = std::move(queues_[i].pinned_.front());
+                    queues_[i].pinned_.pop_front();
+                    --pending_;
+                    return true;
+                }
+                if(!queues_[i].tasks_.empty()){
+                    task = std::move(queues_[i].tasks_.back());
+                    queues_[i].tasks_.pop_back();
+                    --pending_;
+                    return true;
+                }
+            }
+            for(size_t k = 1U; k <= n; ++k){
+                queue& q = queues_[(i+k)%n];
+                std::lock_guard<std::mutex> lock(q.mutex_);
+                if(!q.tasks_.empty()){
+                    task = std::move(q.tasks_.front());
+                    q.tasks_.pop_front();
+                    --pending_;
+                    return true;
+                }
+            }
+            return false;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Worker loop.
+        //!
+        void work(){
+            while(true){
+                const size_t signal = signal_;
+                if(run_one()){
+                    continue;
+                }
+                if(stop_ && pending_ == 0U){
+                    return;
+                }
+                signal_.wait(signal);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Default (process-wide) thread pool, w/ one worker per hardware thread.
+    //!
+    inline thread_pool& default_pool(){
+        static thread_pool pool;
+        return pool;
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Execution policy.
+    //! @note  Example: vla::parallel::fill(a, 0.0)                               : default pool and grain.
+    //!                 vla::parallel::reduce(a, 0.0, std::plus<>{}, {.grain = 64U}) : 64 outer indices per chunk.
+    //!        Arrays (views) are partitioned along their outermost dimension in chunks of grain indices (0: chunks of
+    //!        ~32K elements). If deterministic, reductions combine chunk results in chunk order, hence the result only
+    //!        depends on the grain (not on the number of threads nor on scheduling). Otherwise, chunk results are
+    //!        combined as they complete. If pinned, chunks are statically assigned to workers (see
+    //!        thread_pool::for_range), e.g. to process the pages each worker first touched (see first_touch).
+    //!
+    struct policy{
+        size_t       grain         = 0U;
+        bool         deterministic = false;
+        bool         pinned        = false;
+        thread_pool* pool          = nullptr;
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Pool and grain (outer indices per chunk) of policy p for view v (n0 outer indices, size elements).
+        //!
+        inline thread_pool& pool(const policy& p){
+            return p.pool != nullptr ? *p.pool : default_pool();
+        }
+        inline size_t grain(const policy& p, size_t n0, size_t size) noexcept{
+            if(p.grain != 0U){
+                return p.grain;
+            }
+            const size_t m = n0 == 0U ? 1U : std::max<size_t>(size/n0, 1U);
+            return std::max<size_t>(32768U/m, 1U);
+        }
+        template<typename V>
+        size_t grain(const policy& p, const V& v) noexcept{
+            return grain(p, v.extent(0U), v.size());
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Call f(c, w...) for each chunk c of views v... (w... are the chunks' views).
+        //!
+        template<typename F, typename V0, typename ... V>
+        void for_chunks(const policy& p, F&& f, const V0& v0, const V& ... v){
+            if(((v.extents() != v0.extents()) || ...)){
+                throw std::invalid_argument("parallel::detail::for_chunks(const policy&, F&&, const V0&, const V& ...)");
+            }
+            const size_t g = grain(p, v0);
+            pool(p).for_range(v0.extent(0U), g, [&](size_t first, size_t last){
+                f(first/g, v0.slice(0U, first, last-first), v.slice(0U, first, last-first)...);
+            }, p.pinned);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Fold op(acc, f(x...)) over the elements x... of views v... (nullopt if empty).
+        //!
+        template<typename T, typename R, typename F, typename ... V>
+        std::optional<T> fold(R& op, F& f, const V& ... v){
+            std::optional<T> acc;
+            vla::detail::for_each_row([&](size_t n, auto ... r){
+                size_t j = 0U;
+                if(!acc){
+                    acc.emplace(f(r[0U]...));
+                    j = 1U;
+                }
+                for(; j < n; ++j){
+                    *acc = op(std::move(*acc), f(r[j]...));
+                }
+            }, v...);
+            return acc;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Parallel transform-reduce over views v0, v....
+        //!
+        template<typename T, typename R, typename F, typename V0, typename ... V>
+        T transform_reduce(const policy& p, T init, R op, F f, const V0& v0, const V& ... v){
+            if(p.deterministic){
+                const size_t g = grain(p, v0);
+                std::vector<std::optional<T>> partial((v0.extent(0U)+g-1U)/g);
+                for_chunks(p, [&](size_t i, const auto& ... w){
+                    partial[i] = fold<T>(op, f, w...);
+                }, v0, v...);
+                for(auto& x : partial){
+                    if(x){
+                        init = op(std::move(init), std::move(*x));
+                    }
+                }
+            }
+            else{
+                std::mutex mutex;
+                for_chunks(p, [&](size_t, const auto& ... w){
+                    auto x = fold<T>(op, f, w...);
+                    if(x){
+                        std::lock_guard<std::mutex> lock(mutex);
+                        init = op(std::move(init), std::move(*x));
+                    }
+                }, v0, v...);
+            }
+            return init;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Algorithms: for_range.
+    //!                    for_each.
+    //!                    fill.
+    //!                    transform.
+    //!                    reduce.
+    //!                    transform_reduce.
+    //! @note  Example: vla::parallel::for_each(a, [](double& x){x *= 2.0;})
+    //!                 vla::parallel::transform(a, b, [](double x){return 2.0*x;})            : b = 2*a.
+    //!                 vla::parallel::transform(a, b, c, std::plus<>{})                       : c = a+b.
+    //!                 vla::parallel::reduce(a, 0.0)                                          : sum(a).
+    //!                 vla::parallel::transform_reduce(a, b, 0.0, std::plus<>{}, std::multiplies<>{}) : dot(a, b).
+    //!        x, y, z, ... may be arrays or views, of the same shape.
+    //!
+    template<typename F>
+    void for_range(size_t n, F&& f, const policy& p = {}){
+        detail::pool(p).for_range(n, p.grain != 0U ? p.grain : 1U, std::forward<F>(f), p.pinned);
+    }
+    template<typename X, typename F>
+    void for_each(X&& x, F f, const policy& p = {}){
+        detail::for_chunks(p, [&](size_t, const auto& v){
+            vla::detail::for_each_row([&](size_t n, auto r){
+                for(size_t j = 0U; j < n; ++j){
+                    f(r[j]);
+                }
+            }, v);
+        }, vla::detail::view_of(x));
+    }
+    template<typename X, typename T>
+    void fill(X&& x, const T& value, const policy& p = {}){
+        parallel::for_each(x, [&value](auto& y){y = value;}, p);
+    }
+    template<typename X, typename Y, typename F>
+    void transform(const X& x, Y&& y, F f, const policy& p = {}){
+        detail::for_chunks(p, [&](size_t, const auto& u, const auto& v){
+            vla::detail::for_each_row([&](size_t n, auto r, auto s){
+                for(size_t j = 0U; j < n; ++j){
+                    s[j] = f(r[j]);
+                }
+            }, u, v);
+        }, vla::detail::view_of(x), vla::detail::view_of(y));
+    }
+    template<typename X, typename Y, typename Z, typename F>
+    void transform(const X& x, const Y& y, Z&& z, F f, const policy& p = {}){
+        detail::for_chunks(p, [&](size_t, const auto& u, const auto& v, const auto& w){
+            vla::detail::for_each_row([&](size_t n, auto r, auto s, auto t){
+                for(size_t j = 0U; j < n; ++j){
+                    t[j] = f(r[j], s[j]);
+                }
+            }, u, v, w);
+        }, vla::detail::view_of(x), vla::detail::view_of(y), vla::detail::view_of(z));
+    }
+    template<typename X, typename T, typename R = std::plus<>>
+    T reduce(const X& x, T init, R op = {}, const policy& p = {}){
+        return detail::transform_reduce(p, std::move(init), op, [](const auto& y){return y;}, vla::detail::view_of(x));
+    }
+    template<typename X, typename T, typename R, typename F>
+    T transform_reduce(const X& x, T init, R op, F f, const policy& p = {}){
+        return detail::transform_reduce(p, std::move(init), op, f, vla::detail::view_of(x));
+    }
+    template<typename X, typename Y, typename T, typename R, typename F>
+    T transform_reduce(const X& x, const Y& y, T init, R op, F f, const policy& p = {}){
+        return detail::transform_reduce(p, std::move(init), op, f, vla::detail::view_of(x), vla::detail::view_of(y));
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief First-touch (NUMA-aware) initialisation.
+    //! @note  Example: vla::dynarray<double, 3> a(vla::parallel::first_touch, nx, ny, nz)      : default pool and grain.
+    //!                 vla::dynarray<double, 3> a(vla::parallel::first_touch_t{{.pinned = true, .pool = &p}},
+    //!                                            nx, ny, nz, 1.0)                               : pinned chunks (pool p).
+    //!        Elements are constructed by the pool's workers w/ the same partitioning as the parallel algorithms (chunks
+    //!        of grain outermost indices), hence, under first-touch page placement, each page lands on the NUMA node of
+    //!        the worker that constructed it. Use a bound pool (see thread_pool) and the same pinned policy for
+    //!        construction and subsequent loops to keep every chunk on its node. See numa::placement (Numa.h).
+    //!
+    struct first_touch_t{
+        using is_initializer = void;
+        policy p;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Construct the n(0) blocks (stride elements each) of data w/ args.
+        //!
+        template<typename A, typename T, size_t N, typename ... Args>
+        void operator()(A& a, T* data, const std::array<size_t, N>& extents, size_t stride, const Args& ... args) const{
+            size_t size = 1U;
+            for(auto n : extents){
+                size *= n;
+            }
+            const size_t g = detail::grain(p, extents[0U], size);
+            std::vector<char> done((extents[0U]+g-1U)/g, 0);
+            try{
+                detail::pool(p).for_range(extents[0U], g, [&](size_t first, size_t last){
+                    vla::detail::construct_n(a, data+first*stride, (last-first)*stride, args...);
+                    done[first/g] = 1;
+                }, p.pinned);
+            }
+            catch(...){
+                for(size_t c = 0U; c < done.size(); ++c){
+                    if(done[c] != 0){
+                        vla::detail::destroy_n(a, data+c*g*stride, (std::min(extents[0U], (c+1U)*g)-c*g)*stride);
+                    }
+                }
+                throw;
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    inline constexpr first_touch_t first_touch{}; //!<First-touch construction tag (default policy).
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
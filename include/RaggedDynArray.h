@@ -0,0 +1,345 @@
+/**
+ * @file    RaggedDynArray.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Ragged (jagged, CSR-like) dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_RAGGEDDYNARRAY_H
+#define DYNARRAY_RAGGEDDYNARRAY_H
+
+#include<algorithm>
+#include<initializer_list>
+#include<iostream>
+#include<ranges>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include "Auxiliary.h"
+#include "DynArray.h"
+#include "DynArrayView.h"
+#include "Parallel.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Ragged (variable-length rows) array template.
+    //! @note  Example: vla::ragged_dynarray<int> a(counts)       : rows of counts(0), counts(1), ... elements (0's).
+    //!                 vla::ragged_dynarray<int> a{{1, 2}, {3}, {}} : 3 rows of 2, 1 and 0 elements.
+    //!                 a[i]                                         : 1-D view of row i.
+    //!                 for(auto& x : a){ ... }                      : every element, row after row.
+    //!        Elements of all rows are stored contiguously in a single buffer (row i is [o(i), o(i+1)) of the buffer,
+    //!        where o are the row offsets), e.g. for mesh connectivity (cell-to-faces, node-to-cells, ...), instead of
+    //!        one allocation (and pointer chase) per row. See build for the two-pass (count, then fill) construction.
+    //!
+    template<typename T, template<typename U> typename A = std::allocator>
+    class ragged_dynarray{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using       type_v =       T;                          //!<         Type value      alias.
+        using const_type_v = const T;                          //!<Constant type value      alias.
+        using       type_p =       type_v*;                    //!<         Type pointer    alias.
+        using const_type_p = const type_v*;                    //!<Constant type pointer    alias.
+        using       type_r =       type_v&;                    //!<         Type reference  alias.
+        using const_type_r = const type_v&;                    //!<Constant type reference  alias.
+        using       type_a =     A<type_v>;                    //!<         Type allocator  alias.
+        using       TYPE_O =       dynarray<size_t, 1U, A>;    //!<         Type offsets    alias.
+        using       TYPE_D =       dynarray<T, 1U, A>;         //!<         Type values     alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        TYPE_O offsets_; //!<Row offsets. //!<o(0) = 0, o(1), ..., o(rows) = size.
+        TYPE_D values_;  //!<Values.
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::ragged_dynarray<int> a
+        //!
+        ragged_dynarray() noexcept : offsets_(), values_(){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (row sizes).
+        //! @note  Example: vla::ragged_dynarray<int> a(std::vector<size_t>{2U, 1U})    : rows of 2 and 1 0's.
+        //!                 vla::ragged_dynarray<int> a(std::vector<size_t>{2U, 1U}, 5) : rows of 2 and 1 5's.
+        //!                 vla::ragged_dynarray<int> a(vla::parallel::first_touch, counts) : see Parallel.h.
+        //!        counts may be any sized range of (integer) row sizes, e.g. a vla::dynarray<int>. The remaining
+        //!        arguments are forwarded to each element's constructor.
+        //!
+        template<typename C, typename ... Args> requires(std::ranges::sized_range<const C>)
+        explicit ragged_dynarray(const C& counts, const Args& ... args) : offsets_(prefix(counts)),
+                                                                          values_(offsets_[rows()], args...){
+        }
+        template<typename I, typename C, typename ... Args>
+            requires(detail::is_initializer_v<I> && std::ranges::sized_range<const C>)
+        explicit ragged_dynarray(const I& initializer, const C& counts, const Args& ... args) :
+            offsets_(prefix(counts)), values_(initializer, offsets_[rows()], args...){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (CSR arrays).
+        //! @note  Example: vla::ragged_dynarray<int> a(std::move(o), std::move(v)) : o = {0, 2, 3}, v = {1, 2, 3}.
+        //!        Offsets must start at 0, be non-decreasing and end at values.size().
+        //!
+        explicit ragged_dynarray(TYPE_O&& offsets, TYPE_D&& values) : offsets_(std::move(offsets)),
+                                                                      values_(std::move(values)){
+            if(offsets_.empty() ? !values_.empty() : offsets_[0U] != 0U || offsets_[rows()] != values_.size() ||
+               !std::is_sorted(offsets_.begin(), offsets_.end())){
+                throw std::invalid_argument("ragged_dynarray<T, A>::ragged_dynarray(TYPE_O&&, TYPE_D&&)");
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::ragged_dynarray<int> a{{1, 2}, {3}, {}} : 3 rows of 2, 1 and 0 elements.
+        //!
+        ragged_dynarray(std::initializer_list<std::initializer_list<T>> il) :
+            ragged_dynarray(std::views::transform(il, [](const auto& r){return r.size();})){
+            size_t i = 0U;
+            for(const auto& r : il){
+                std::copy(r.begin(), r.end(), values_.begin()+offsets_[i++]);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Factory (two passes: count, then fill).
+        //! @note  Example: auto a = vla::ragged_dynarray<int>::build(n, [&](size_t i){return cells[i].size();},
+        //!                                                           [&](size_t i, auto r){ ... r[j] = ...; })
+        //!                 auto a = vla::ragged_dynarray<int>::build(n, count, fill, {.grain = 64U}) : in parallel.
+        //!        count(i) returns the size of row i and fill(i, r) writes the elements of row i through view r. In
+        //!        parallel, both passes are split in chunks of rows (count and fill must be thread-safe across rows)
+        //!        and elements are constructed by the pool's workers (see parallel::first_touch).
+        //!
+        template<typename F, typename G>
+        static ragged_dynarray build(size_t rows, F count, G fill){
+            TYPE_O offsets(rows+1U);
+            for(size_t i = 0U; i < rows; ++i){
+                offsets[i+1U] = detail::index(count(i));
+            }
+            scan(offsets);
+            ragged_dynarray a(std::move(offsets), TYPE_D(offsets[rows]));
+            for(size_t i = 0U; i < rows; ++i){
+                fill(i, a[i]);
+            }
+            return a;
+        }
+        template<typename F, typename G>
+        static ragged_dynarray build(size_t rows, F count, G fill, const parallel::policy& p){
+            parallel::policy q = p;
+            q.grain = parallel::detail::grain(p, rows, rows);
+            TYPE_O offsets(rows+1U);
+            parallel::for_range(rows, [&](size_t first, size_t last){
+                for(size_t i = first; i < last; ++i){
+                    offsets[i+1U] = detail::index(count(i));
+                }
+            }, q);
+            scan(offsets);
+            ragged_dynarray a(std::move(offsets), TYPE_D(parallel::first_touch_t{p}, offsets[rows]));
+            parallel::for_range(rows, [&](size_t first, size_t last){
+                for(size_t i = first; i < last; ++i){
+                    fill(i, a[i]);
+                }
+            }, q);
+            return a;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: at.
+        //!                        operator[] (1-D view of row i).
+        //!                        operator() (element j of row i).
+        //!                        data.
+        //!
+        dynarray_view<T, 1U> at(size_t i){
+            if(i >= rows()){
+                throw std::out_of_range("ragged_dynarray<T, A>::at(size_t)");
+            }
+            return (*this)[i];
+        }
+        dynarray_view<const T, 1U> at(size_t i) const{
+            if(i >= rows()){
+                throw std::out_of_range("ragged_dynarray<T, A>::at(size_t) const");
+            }
+            return (*this)[i];
+        }
+        type_r at(size_t i, size_t j){
+            if(i >= rows() || j >= size(i)){
+                throw std::out_of_range("ragged_dynarray<T, A>::at(size_t, size_t)");
+            }
+            return (*this)(i, j);
+        }
+        const_type_r at(size_t i, size_t j) const{
+            if(i >= rows() || j >= size(i)){
+                throw std::out_of_range("ragged_dynarray<T, A>::at(size_t, size_t) const");
+            }
+            return (*this)(i, j);
+        }
+        dynarray_view<T, 1U> operator[](size_t i) noexcept{
+            return dynarray_view<T, 1U>(values_.data()+offsets_[i], {size(i)});
+        }
+        dynarray_view<const T, 1U> operator[](size_t i) const noexcept{
+            return dynarray_view<const T, 1U>(values_.data()+offsets_[i], {size(i)});
+        }
+        type_r operator()(size_t i, size_t j) noexcept{
+            return values_[offsets_[i]+j];
+        }
+        const_type_r operator()(size_t i, size_t j) const noexcept{
+            return values_[offsets_[i]+j];
+        }
+        type_p data() noexcept{
+            return values_.data();
+        }
+        const_type_p data() const noexcept{
+            return values_.data();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Iterators (every element, row after row): begin.
+        //!                                                  end.
+        //!
+        type_p begin() noexcept{
+            return values_.begin();
+        }
+        const_type_p begin() const noexcept{
+            return values_.begin();
+        }
+        type_p end() noexcept{
+            return values_.end();
+        }
+        const_type_p end() const noexcept{
+            return values_.end();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: empty.
+        //!                  rows.
+        //!                  size    (number of elements of all rows, or of row i).
+        //!                  offsets (1-D view of the row offsets o(0), o(1), ..., o(rows)).
+        //!                  values  (1-D view of the elements).
+        //!
+        bool empty() const noexcept{
+            return values_.empty();
+        }
+        size_t rows() const noexcept{
+            return offsets_.empty() ? 0U : offsets_.size()-1U;
+        }
+        size_t size() const noexcept{
+            return values_.size();
+        }
+        size_t size(size_t i) const noexcept{
+            return offsets_[i+1U]-offsets_[i];
+        }
+        dynarray_view<const size_t, 1U> offsets() const noexcept{
+            return offsets_.view();
+        }
+        dynarray_view<T, 1U> values() noexcept{
+            return values_.view();
+        }
+        dynarray_view<const T, 1U> values() const noexcept{
+            return values_.view();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory footprint: payload_bytes.
+        //!                          metadata_bytes.
+        //!                          allocation_count.
+        //! @note  payload_bytes() is the size of the element storage, metadata_bytes() the size of the array object
+        //!        itself plus the row offsets. allocation_count() is only available w/ a counting allocator (see
+        //!        vla::counting_allocator).
+        //!
+        size_t payload_bytes() const noexcept{
+            return values_.payload_bytes();
+        }
+        size_t metadata_bytes() const noexcept{
+            return sizeof(ragged_dynarray)+offsets_.payload_bytes();
+        }
+        size_t allocation_count() const noexcept requires(requires(const type_a& a){a.allocation_count();}){
+            return offsets_.allocation_count()+values_.allocation_count();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: fill.
+        //!                    swap.
+        //!                    get_allocator.
+        //!
+        void fill(const_type_v& value) noexcept{
+            values_.fill(value);
+        }
+        friend void swap(ragged_dynarray& lhs, ragged_dynarray& rhs) noexcept{
+            swap(lhs.offsets_, rhs.offsets_);
+            swap(lhs.values_, rhs.values_);
+        }
+        type_a get_allocator() const noexcept{
+            return values_.get_allocator();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator<< .
+        //!                              operator== .
+        //!                              operator!= .
+        //!
+        friend std::ostream& operator<<(std::ostream& o, const ragged_dynarray& other) noexcept{
+            o << "[";
+            for(size_t i = 0U; i < other.rows(); ++i){
+                o << "[";
+                for(size_t j = 0U; j < other.size(i); ++j){
+                    if(j < other.size(i)-1U){
+                        o << other(i, j) << " ";
+                    }
+                    else{
+                        o << other(i, j);
+                    }
+                }
+                o << (i < other.rows()-1U ? "] " : "]");
+            }
+            return o << "]";
+        }
+        friend bool operator==(const ragged_dynarray& lhs, const ragged_dynarray& rhs){
+            return lhs.rows() == rhs.rows() && (lhs.rows() == 0U || lhs.offsets_ == rhs.offsets_) &&
+                   lhs.values_ == rhs.values_;
+        }
+        friend bool operator!=(const ragged_dynarray& lhs, const ragged_dynarray& rhs){
+            return !(lhs == rhs);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Row offsets from row sizes (exclusive prefix sum).
+        //!
+        template<typename C>
+        static TYPE_O prefix(const C& counts){
+            TYPE_O offsets(std::ranges::size(counts)+1U);
+            size_t i = 0U;
+            for(const auto& n : counts){
+                offsets[i+1U] = offsets[i]+detail::index(n);
+                ++i;
+            }
+            return offsets;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Row offsets from row sizes stored in offsets[1], offsets[2], ... (in place).
+        //!
+        static void scan(TYPE_O& offsets) noexcept{
+            for(size_t i = 1U; i < offsets.size(); ++i){
+                offsets[i] += offsets[i-1U];
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
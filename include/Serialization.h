@@ -0,0 +1,534 @@
+/**
+ * @file    Serialization.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Binary serialization (versioned header + raw payload) for the dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_SERIALIZATION_H
+#define DYNARRAY_SERIALIZATION_H
+
+#include<array>
+#include<bit>
+#include<cerrno>
+#include<climits>
+#include<cstdint>
+#include<cstring>
+#include<filesystem>
+#include<stdexcept>
+#include<system_error>
+#include<tuple>
+#include<type_traits>
+#include<vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include<fcntl.h>
+#include<sys/uio.h>
+#include<unistd.h>
+#endif
+
+#include "Allocator.h"
+#include "Auxiliary.h"
+#include "DynArray.h"
+#include "DynArrayView.h"
+#include "RaggedDynArray.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Binary format (version 1).
+        //! @note  Offset       Bytes  Field
+        //!        0            8      magic ("DYNARRAY").
+        //!        8            4      version.
+        //!        12           4      endianness (0x01020304 in the writer's byte order).
+        //!        16           4      element type (kind << 16 | size, see type_code<T>).
+        //!        20           4      rank (N).
+        //!        24           8      payload alignment (bytes).
+        //!        32           8      payload offset (bytes, multiple of the alignment).
+        //!        40           8*N    extents n(0), n(1), ...
+        //!        offset       ...    payload (row-major elements, writer's byte order, no padding).
+        //!        Header fields are stored in the writer's byte order as well.
+        //!
+        struct header{
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t endian;
+            std::uint32_t type;
+            std::uint32_t rank;
+            std::uint64_t alignment;
+            std::uint64_t offset;
+        };
+        inline constexpr char          format_magic[8] = {'D', 'Y', 'N', 'A', 'R', 'R', 'A', 'Y'};
+        inline constexpr std::uint32_t format_version  = 1U;
+        inline constexpr std::uint32_t format_endian   = 0x01020304U;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element type code (kind << 16 | sizeof(T)), where kind is 1/2/3/4 for signed/unsigned/floating
+        //!        point/bool and 0 for any other (trivially copyable) type.
+        //!
+        template<typename T>
+        consteval std::uint32_t type_code() noexcept{
+            std::uint32_t kind = 0U;
+            if constexpr(std::is_same_v<T, bool>){
+                kind = 4U;
+            }
+            else if constexpr(std::is_floating_point_v<T>){
+                kind = 3U;
+            }
+            else if constexpr(std::is_integral_v<T>){
+                kind = std::is_signed_v<T> ? 1U : 2U;
+            }
+            return kind << 16U | static_cast<std::uint32_t>(sizeof(T));
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Reverse the byte order of x (arithmetic types).
+        //!
+        template<typename T>
+        T byteswap(T x) noexcept{
+            if constexpr(sizeof(T) == 1U){
+                return x;
+            }
+            else{
+                using U = std::conditional_t<sizeof(T) == 2U, std::uint16_t,
+                          std::conditional_t<sizeof(T) == 4U, std::uint32_t, std::uint64_t>>;
+                return std::bit_cast<T>(std::byteswap(std::bit_cast<U>(x)));
+            }
+        }
+        inline void byteswap(header& h) noexcept{
+            h.version   = byteswap(h.version);
+            h.endian    = byteswap(h.endian);
+            h.type      = byteswap(h.type);
+            h.rank      = byteswap(h.rank);
+            h.alignment = byteswap(h.alignment);
+            h.offset    = byteswap(h.offset);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+#if defined(__unix__) || defined(__APPLE__)
+        //!
+        //! @brief Scatter/gather I/O: transfer every byte of the n buffers v (writev/readv, IOV_MAX buffers per call).
+        //!
+        template<bool Write>
+        void transfer(int fd, iovec* v, size_t n, const char* what){
+            while(n > 0U){
+                const int     m = static_cast<int>(std::min<size_t>(n, IOV_MAX));
+                const ssize_t k = Write ? ::writev(fd, v, m) : ::readv(fd, v, m);
+                if(k < 0){
+                    if(errno == EINTR){
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), what);
+                }
+                if(k == 0){
+                    throw std::system_error(std::make_error_code(std::errc::io_error), what); //!<Truncated file.
+                }
+                size_t r = index(k);
+                while(n > 0U && r >= v->iov_len){
+                    r -= v->iov_len;
+                    ++v;
+                    --n;
+                }
+                if(n > 0U){
+                    v->iov_base  = static_cast<char*>(v->iov_base)+r;
+                    v->iov_len  -= r;
+                }
+            }
+        }
+#endif
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Call f(p, n) for each contiguous block [p, p+n) of the elements of view v (row-major order).
+        //! @note  A single block if v is contiguous, one block per row otherwise (one per element if the innermost
+        //!        stride is not 1, e.g. transposed views).
+        //!
+        template<typename T, size_t N, typename F>
+        void for_each_block(const dynarray_view<T, N>& v, F&& f){
+            for_each_row([&](size_t n, auto r){
+                if constexpr(std::is_pointer_v<decltype(r)>){
+                    f(r, n);
+                }
+                else if(r.stride == 1U){
+                    f(r.head, n);
+                }
+                else{
+                    for(size_t j = 0U; j < n; ++j){
+                        f(&r[j], 1U);
+                    }
+                }
+            }, v);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Path of the row offsets of a ragged array saved to path (path + ".offsets").
+        //!
+        inline std::filesystem::path offsets_path(std::filesystem::path path){
+            path += ".offsets";
+            return path;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+#if defined(__unix__) || defined(__APPLE__)
+    //!
+    //! @brief Binary writer template (streams an N-D array to a file in chunks of outermost indices).
+    //! @note  Example: vla::binary_writer<double, 3> w("u.bin", {nx, ny, nz})
+    //!                 for(...){ w.write(chunk); }     : chunk(s) of ki x ny x nz elements (k0+k1+... = nx).
+    //!                 w.close()
+    //!        The header is written together w/ the first chunk (single writev). Chunks may be arrays or views of any
+    //!        layout; contiguous chunks are written w/o intermediate copies.
+    //!
+    template<typename T, size_t N = 1U>
+    class binary_writer{
+        static_assert(std::is_trivially_copyable_v<T>, "binary_writer<T, N>: T must be trivially copyable.");
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using TYPE_E = std::array<size_t, N>; //!<Type extents alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        int               fd_;      //!<File descriptor.
+        TYPE_E            extents_; //!<Extents.
+        size_t            rows_;    //!<Outermost indices written so far.
+        std::vector<char> header_;  //!<Pending header (empty once written).
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  alignment is the alignment (bytes) of the payload w.r.t. the file start (see load_mapped).
+        //!
+        explicit binary_writer(const std::filesystem::path& path, const TYPE_E& extents, size_t alignment = 64U) :
+            fd_(-1), extents_(extents), rows_(0U){
+            if(alignment == 0U || alignment%alignof(T) != 0U){
+                throw std::invalid_argument("binary_writer<T, N>::binary_writer(const path&, const TYPE_E&, size_t)");
+            }
+            // Initialise...
+            const size_t bytes = sizeof(detail::header)+N*sizeof(std::uint64_t);
+            detail::header h{};
+            std::memcpy(h.magic, detail::format_magic, sizeof(h.magic));
+            h.version   = detail::format_version;
+            h.endian    = detail::format_endian;
+            h.type      = detail::type_code<T>();
+            h.rank      = static_cast<std::uint32_t>(N);
+            h.alignment = alignment;
+            h.offset    = (bytes+alignment-1U)/alignment*alignment;
+            header_.assign(h.offset, '\0');
+            std::memcpy(header_.data(), &h, sizeof(h));
+            for(size_t k = 0U; k < N; ++k){
+                const std::uint64_t n = extents_[k];
+                std::memcpy(header_.data()+sizeof(h)+k*sizeof(n), &n, sizeof(n));
+            }
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(fd_ < 0){
+                throw std::system_error(errno, std::generic_category(),
+                                        "binary_writer<T, N>::binary_writer(const path&, const TYPE_E&, size_t)");
+            }
+        }
+        binary_writer(const binary_writer&) = delete;
+        binary_writer& operator=(const binary_writer&) = delete;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor (closes the file; call close() to check for errors).
+        //!
+        ~binary_writer() noexcept{
+            if(fd_ >= 0){
+                ::close(fd_);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: extents.
+        //!                  remaining (outermost indices left to write).
+        //!
+        const TYPE_E& extents() const noexcept{
+            return extents_;
+        }
+        size_t remaining() const noexcept{
+            return extents_[0U]-rows_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: write (next x.extent(0) outermost indices).
+        //!                    close.
+        //!
+        template<typename X>
+        void write(const X& x){
+            const auto v = detail::view_of(x);
+            static_assert(std::is_same_v<std::remove_const_t<std::remove_pointer_t<decltype(v.data())>>, T> &&
+                          std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>> == N,
+                          "binary_writer<T, N>::write(const X&): X must be a T array (view) of rank N.");
+            for(size_t k = 1U; k < N; ++k){
+                if(v.extent(k) != extents_[k]){
+                    throw std::invalid_argument("binary_writer<T, N>::write(const X&)");
+                }
+            }
+            if(fd_ < 0 || v.extent(0U) > remaining()){
+                throw std::invalid_argument("binary_writer<T, N>::write(const X&)");
+            }
+            // Gather header (if pending) and blocks...
+            std::vector<iovec> blocks;
+            if(!header_.empty()){
+                blocks.push_back({header_.data(), header_.size()});
+            }
+            if(!v.empty()){
+                detail::for_each_block(v, [&blocks](const T* p, size_t n){
+                    blocks.push_back({const_cast<T*>(p), n*sizeof(T)});
+                });
+            }
+            detail::transfer<true>(fd_, blocks.data(), blocks.size(), "binary_writer<T, N>::write(const X&)");
+            header_.clear();
+            rows_ += v.extent(0U);
+        }
+        void close(){
+            if(fd_ < 0){
+                return;
+            }
+            if(!header_.empty()){
+                iovec h{header_.data(), header_.size()};
+                detail::transfer<true>(fd_, &h, 1U, "binary_writer<T, N>::close()");
+                header_.clear();
+            }
+            const int fd = fd_;
+            fd_ = -1;
+            if(::close(fd) != 0){
+                throw std::system_error(errno, std::generic_category(), "binary_writer<T, N>::close()");
+            }
+            if(rows_ != extents_[0U]){
+                throw std::invalid_argument("binary_writer<T, N>::close()"); //!<Incomplete array.
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Binary reader template (streams an N-D array from a file in chunks of outermost indices).
+    //! @note  Example: vla::binary_reader<double, 3> r("u.bin")
+    //!                 while(r.remaining() > 0U){ r.read(chunk); } : chunk(s) of ki x ny x nz elements.
+    //!        The element type and rank must match the file's. Files written on a machine of the opposite byte order
+    //!        are converted on the fly (arithmetic types only).
+    //!
+    template<typename T, size_t N = 1U>
+    class binary_reader{
+        static_assert(std::is_trivially_copyable_v<T>, "binary_reader<T, N>: T must be trivially copyable.");
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using TYPE_E = std::array<size_t, N>; //!<Type extents alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        int    fd_;      //!<File descriptor.
+        TYPE_E extents_; //!<Extents.
+        size_t rows_;    //!<Outermost indices read so far.
+        size_t offset_;  //!<Payload offset (bytes).
+        bool   swap_;    //!<Opposite byte order.
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (reads and validates the header).
+        //!
+        explicit binary_reader(const std::filesystem::path& path) : fd_(-1), rows_(0U), offset_(0U), swap_(false){
+            fd_ = ::open(path.c_str(), O_RDONLY);
+            if(fd_ < 0){
+                throw std::system_error(errno, std::generic_category(),
+                                        "binary_reader<T, N>::binary_reader(const path&)");
+            }
+            try{
+                detail::header h{};
+                std::array<std::uint64_t, N> n{};
+                iovec v[2] = {{&h, sizeof(h)}, {n.data(), sizeof(n)}};
+                detail::transfer<false>(fd_, v, 2U, "binary_reader<T, N>::binary_reader(const path&)");
+                if(std::memcmp(h.magic, detail::format_magic, sizeof(h.magic)) != 0){
+                    throw std::invalid_argument("binary_reader<T, N>::binary_reader(const path&)"); //!<Not a dynarray.
+                }
+                if(h.endian != detail::format_endian){
+                    swap_ = true;
+                    detail::byteswap(h);
+                    for(auto& x : n){
+                        x = detail::byteswap(x);
+                    }
+                }
+                if(h.endian != detail::format_endian || h.version > detail::format_version ||
+                   h.type != detail::type_code<T>() || h.rank != N || (swap_ && !std::is_arithmetic_v<T>)){
+                    throw std::invalid_argument("binary_reader<T, N>::binary_reader(const path&)");
+                }
+                for(size_t k = 0U; k < N; ++k){
+                    extents_[k] = detail::convert<size_t>(n[k]);
+                }
+                offset_ = detail::convert<size_t>(h.offset);
+                if(::lseek(fd_, detail::convert<off_t>(offset_), SEEK_SET) < 0){
+                    throw std::system_error(errno, std::generic_category(),
+                                            "binary_reader<T, N>::binary_reader(const path&)");
+                }
+            }
+            catch(...){
+                ::close(fd_);
+                throw;
+            }
+        }
+        binary_reader(const binary_reader&) = delete;
+        binary_reader& operator=(const binary_reader&) = delete;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor.
+        //!
+        ~binary_reader() noexcept{
+            ::close(fd_);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: extents.
+        //!                  remaining (outermost indices left to read).
+        //!                  offset    (payload offset, bytes).
+        //!                  swapped   (whether the file has the opposite byte order).
+        //!
+        const TYPE_E& extents() const noexcept{
+            return extents_;
+        }
+        size_t remaining() const noexcept{
+            return extents_[0U]-rows_;
+        }
+        size_t offset() const noexcept{
+            return offset_;
+        }
+        bool swapped() const noexcept{
+            return swap_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: read (next x.extent(0) outermost indices).
+        //!
+        template<typename X>
+        void read(X&& x){
+            const auto v = detail::view_of(x);
+            static_assert(std::is_same_v<std::remove_pointer_t<decltype(v.data())>, T> &&
+                          std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>> == N,
+                          "binary_reader<T, N>::read(X&&): X must be a (non-constant) T array (view) of rank N.");
+            for(size_t k = 1U; k < N; ++k){
+                if(v.extent(k) != extents_[k]){
+                    throw std::invalid_argument("binary_reader<T, N>::read(X&&)");
+                }
+            }
+            if(v.extent(0U) > remaining()){
+                throw std::invalid_argument("binary_reader<T, N>::read(X&&)");
+            }
+            if(v.empty()){
+                return;
+            }
+            // Scatter blocks...
+            std::vector<iovec> blocks;
+            detail::for_each_block(v, [&blocks](T* p, size_t n){
+                blocks.push_back({p, n*sizeof(T)});
+            });
+            detail::transfer<false>(fd_, blocks.data(), blocks.size(), "binary_reader<T, N>::read(X&&)");
+            if constexpr(std::is_arithmetic_v<T>){
+                if(swap_){
+                    detail::for_each_block(v, [](T* p, size_t n){
+                        for(size_t j = 0U; j < n; ++j){
+                            p[j] = detail::byteswap(p[j]);
+                        }
+                    });
+                }
+            }
+            rows_ += v.extent(0U);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Save/load arrays (views).
+    //! @note  Example: vla::save("u.bin", a)                              : single writev (header + payload).
+    //!                 vla::load("u.bin", a)                              : into an existing array (same extents).
+    //!                 auto a = vla::load<double, 3>("u.bin")             : into a new array.
+    //!                 auto a = vla::load_mapped<double, 3>("u.bin")      : zero-copy (file-backed array).
+    //!        load_mapped requires a file of the same byte order. See binary_writer/binary_reader to stream arrays in
+    //!        chunks.
+    //!
+    template<typename X>
+    void save(const std::filesystem::path& path, const X& x, size_t alignment = 64U){
+        const auto v = detail::view_of(x);
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(v.data())>>;
+        constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>>;
+        binary_writer<T, N> w(path, v.extents(), alignment);
+        w.write(v);
+        w.close();
+    }
+    template<typename X>
+    void load(const std::filesystem::path& path, X&& x){
+        const auto v = detail::view_of(x);
+        using T = std::remove_pointer_t<decltype(v.data())>;
+        constexpr size_t N = std::tuple_size_v<std::remove_cvref_t<decltype(v.extents())>>;
+        binary_reader<T, N> r(path);
+        if(r.extents() != v.extents()){
+            throw std::invalid_argument("vla::load(const path&, X&&)");
+        }
+        r.read(v);
+    }
+    template<typename T, size_t N = 1U, template<typename U> typename A = std::allocator>
+    dynarray<T, N, A> load(const std::filesystem::path& path){
+        binary_reader<T, N> r(path);
+        auto a = std::apply([](auto ... n){
+            if constexpr(std::is_trivially_default_constructible_v<T>){
+                return dynarray<T, N, A>(default_init, n...);
+            }
+            else{
+                return dynarray<T, N, A>(n...);
+            }
+        }, r.extents());
+        r.read(a);
+        return a;
+    }
+    template<typename T, size_t N = 1U>
+    dynarray<T, N, mapped_allocator> load_mapped(const std::filesystem::path& path,
+                                                 map_mode mode = map_mode::read_only){
+        size_t offset = 0U;
+        std::array<size_t, N> extents{};
+        {
+            binary_reader<T, N> r(path);
+            if(r.swapped() || r.offset()%alignof(T) != 0U){
+                throw std::invalid_argument("vla::load_mapped<T, N>(const path&, map_mode)");
+            }
+            offset  = r.offset();
+            extents = r.extents();
+        }
+        return std::apply([&](auto ... n){
+            return dynarray<T, N, mapped_allocator>::map(mapped_allocator<T>(path, mode, offset), n...);
+        }, extents);
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Save/load ragged arrays.
+    //! @note  Example: vla::save("c2f.bin", a)                      : elements in c2f.bin, offsets in c2f.bin.offsets.
+    //!                 auto a = vla::load_ragged<int>("c2f.bin")    : into a new array.
+    //!        Both files are plain 1-D arrays (see save/load), e.g. the elements may be mapped w/ load_mapped.
+    //!
+    template<typename T, template<typename U> typename A>
+    void save(const std::filesystem::path& path, const ragged_dynarray<T, A>& x, size_t alignment = 64U){
+        save(path, x.values(), alignment);
+        save(detail::offsets_path(path), x.offsets(), alignment);
+    }
+    template<typename T, template<typename U> typename A = std::allocator>
+    ragged_dynarray<T, A> load_ragged(const std::filesystem::path& path){
+        auto offsets = load<size_t, 1U, A>(detail::offsets_path(path));
+        auto values  = load<T, 1U, A>(path);
+        return ragged_dynarray<T, A>(std::move(offsets), std::move(values));
+    }
+#endif
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,518 @@
+/**
+ * @file    SmallDynArray.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Small-buffer (inline storage) 1-D dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_SMALLDYNARRAY_H
+#define DYNARRAY_SMALLDYNARRAY_H
+
+#include<algorithm>
+#include<array>
+#include<initializer_list>
+#include<iostream>
+#include<limits>
+#include<memory>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include "Auxiliary.h"
+#include "DynArrayView.h"
+#include "Expression.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief 1-D (dynamic) array template w/ inline storage for up to Inline elements.
+    //! @note  Example: vla::small_dynarray<int, 4> a(3U)     : 3 elements stored inside a (no allocation).
+    //!                 vla::small_dynarray<int, 4> a(8U, 1)  : 8 elements stored in the heap (w/ allocator A).
+    //!        Drop-in replacement for vla::dynarray<T, 1, A> (same element access, iterators, capacity, views and
+    //!        expression interface) for short arrays, e.g. cell-to-node lists: no allocation nor pointer chase to
+    //!        a separate block while size() <= Inline. Moving an inline array moves its elements (O(Inline)).
+    //!
+    template<typename T, size_t Inline = 4U, template<typename U> typename A = std::allocator>
+    class small_dynarray{
+        static_assert(Inline > 0U, "small_dynarray<T, Inline, A>: Inline must be positive.");
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using       type_v =       T;              //!<         Type value      alias.
+        using const_type_v = const T;              //!<Constant type value      alias.
+        using       type_p =       type_v*;        //!<         Type pointer    alias.
+        using const_type_p = const type_v*;        //!<Constant type pointer    alias.
+        using       type_r =       type_v&;        //!<         Type reference  alias.
+        using const_type_r = const type_v&;        //!<Constant type reference  alias.
+        using       type_a =     A<type_v>;        //!<         Type allocator  alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        size_t                              size_;                         //!<Type              size.
+        size_t                              capacity_;                     //!<Type              capacity (>= Inline).
+        [[no_unique_address]] type_a        allocator_;                    //!<Type              allocator.
+        type_p                              head_;                         //!<Type (pointer to) head (buffer_ or heap).
+        alignas(T) unsigned char            buffer_[Inline*sizeof(T)];     //!<Inline storage.
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::small_dynarray<int> a
+        //!
+        small_dynarray() noexcept : size_(0U), capacity_(Inline), head_(buffer()){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::small_dynarray<int> a(3U)    : 3-element (integer) array filled with 0's.
+        //!                 vla::small_dynarray<int> a(3U, 5) : 3-element (integer) array filled with 5's.
+        //!
+        template<typename ... Args>
+        explicit small_dynarray(size_t n, Args&& ... args) : small_dynarray(){
+            reserve(n);
+            // Construct...
+            detail::construct_n(allocator_, head_, n, args...);
+            size_ = n;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (uninitialised/default-initialised elements).
+        //! @note  Example: vla::small_dynarray<double> a(vla::uninitialized, 3U) : no element is written.
+        //!                 vla::small_dynarray<double> a(vla::default_init,  3U) : idem (T is trivial).
+        //!
+        explicit small_dynarray(uninitialized_t, size_t n) : small_dynarray(default_init, n){
+            static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                          "small_dynarray<T, Inline, A>::small_dynarray(uninitialized_t, size_t): T must be trivial.");
+        }
+        explicit small_dynarray(default_init_t, size_t n) : small_dynarray(){
+            reserve(n);
+            // Construct...
+            detail::default_init_n(allocator_, head_, n);
+            size_ = n;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::small_dynarray<int> a{1, 2, 3}
+        //!
+        explicit small_dynarray(std::initializer_list<T> il) : small_dynarray(){
+            reserve(il.size());
+            // Construct...
+            detail::copy_n(allocator_, il.begin(), il.size(), head_);
+            size_ = il.size();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy constructor (deep copy).
+        //!
+        small_dynarray(const small_dynarray& other) :
+            small_dynarray(std::allocator_traits<type_a>::select_on_container_copy_construction(other.allocator_)){
+            reserve(other.size_);
+            // Construct...
+            detail::copy_n(allocator_, other.head_, other.size_, head_);
+            size_ = other.size_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Move constructor (steals heap storage, relocates inline elements).
+        //!
+        small_dynarray(small_dynarray&& other) noexcept(std::is_nothrow_move_constructible_v<T>) :
+            small_dynarray(type_a(other.allocator_)){
+            steal(other);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy/move assignment.
+        //!
+        small_dynarray& operator=(const small_dynarray& other){
+            if(this != &other){
+                *this = small_dynarray(other);
+            }
+            return *this;
+        }
+        small_dynarray& operator=(small_dynarray&& other) noexcept(std::is_nothrow_move_constructible_v<T>){
+            if(this != &other){
+                release();
+                allocator_ = other.allocator_;
+                steal(other);
+            }
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Expression assignment (single fused pass, no temporaries). See expression<E> (Expression.h).
+        //!
+        template<typename E>
+        small_dynarray& operator=(const expression<E>& e){
+            view() = e;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<small_dynarray, X>)
+        small_dynarray& operator+=(const X& x){
+            view() += x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<small_dynarray, X>)
+        small_dynarray& operator-=(const X& x){
+            view() -= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<small_dynarray, X>)
+        small_dynarray& operator*=(const X& x){
+            view() *= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<small_dynarray, X>)
+        small_dynarray& operator/=(const X& x){
+            view() /= x;
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor.
+        //!
+        ~small_dynarray() noexcept{
+            release();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: at.
+        //!                        operator[].
+        //!                        operator().
+        //!                        front.
+        //!                        back.
+        //!                        data.
+        //!
+        type_r at(size_t i){
+            if(i >= size_){
+                throw std::out_of_range("small_dynarray<T, Inline, A>::at(size_t)");
+            }
+            return (*this)[i];
+        }
+        const_type_r at(size_t i) const{
+            if(i >= size_){
+                throw std::out_of_range("small_dynarray<T, Inline, A>::at(size_t) const");
+            }
+            return (*this)[i];
+        }
+        type_r operator[](size_t i) noexcept{
+            return *(head_+i);
+        }
+        const_type_r operator[](size_t i) const noexcept{
+            return *(head_+i);
+        }
+        type_r operator()(size_t i) noexcept{
+            return *(head_+i);
+        }
+        const_type_r operator()(size_t i) const noexcept{
+            return *(head_+i);
+        }
+        type_r front() noexcept{
+            return (*this)[0U];
+        }
+        const_type_r front() const noexcept{
+            return (*this)[0U];
+        }
+        type_r back() noexcept{
+            return (*this)[size_-1U];
+        }
+        const_type_r back() const noexcept{
+            return (*this)[size_-1U];
+        }
+        type_p data() noexcept{
+            return head_;
+        }
+        const_type_p data() const noexcept{
+            return head_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Iterators: begin.
+        //!                   end.
+        //!
+        type_p begin() noexcept{
+            return head_;
+        }
+        const_type_p begin() const noexcept{
+            return head_;
+        }
+        type_p end() noexcept{
+            return head_+size_;
+        }
+        const_type_p end() const noexcept{
+            return head_+size_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: empty.
+        //!                  size.
+        //!                  max_size.
+        //!                  extent.
+        //!                  extents.
+        //!                  stride.
+        //!                  leading_dimension.
+        //!                  is_contiguous.
+        //!                  capacity.
+        //!                  is_inline.
+        //!
+        bool empty() const noexcept{
+            return size_ == 0U;
+        }
+        size_t size() const noexcept{
+            return size_;
+        }
+        size_t max_size() const noexcept{
+            return static_cast<size_t>(std::numeric_limits<size_d>::max());
+        }
+        size_t extent(size_t) const noexcept{
+            return size_;
+        }
+        std::array<size_t, 1U> extents() const noexcept{
+            return {size_};
+        }
+        size_t stride(size_t) const noexcept{
+            return 1U;
+        }
+        size_t leading_dimension() const noexcept{
+            return size_;
+        }
+        bool is_contiguous() const noexcept{
+            return true;
+        }
+        size_t capacity() const noexcept{
+            return capacity_;
+        }
+        bool is_inline() const noexcept{
+            return head_ == buffer();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory footprint: payload_bytes.
+        //!                          metadata_bytes.
+        //!                          allocation_count.
+        //! @note  payload_bytes() is the size of the heap storage (0 while inline), metadata_bytes() the size of the
+        //!        array object itself (incl. the inline storage).
+        //!        allocation_count() is only available w/ a counting allocator (see vla::counting_allocator).
+        //!
+        size_t payload_bytes() const noexcept{
+            return is_inline() ? 0U : capacity_*sizeof(T);
+        }
+        size_t metadata_bytes() const noexcept{
+            return sizeof(small_dynarray);
+        }
+        size_t allocation_count() const noexcept requires(requires(const type_a& a){a.allocation_count();}){
+            return allocator_.allocation_count();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Modifiers: reserve.
+        //!                   resize.
+        //!                   shrink_to_fit (moves the elements back inline if they fit).
+        //! @note  See dynarray<T, 1, A>::resize.
+        //!
+        void reserve(size_t n){
+            if(n > capacity_){
+                if(n >= max_size()){
+                    throw std::invalid_argument("small_dynarray<T, Inline, A>::reserve(size_t)");
+                }
+                reallocate(n);
+            }
+        }
+        template<typename ... Args>
+        void resize(size_t n, const Args& ... args){
+            if(n > size_){
+                if(n > capacity_){
+                    if(n >= max_size()){
+                        throw std::invalid_argument("small_dynarray<T, Inline, A>::resize(size_t, const Args& ...)");
+                    }
+                    reallocate(std::max(n, capacity_+capacity_/2U));
+                }
+                detail::construct_n(allocator_, head_+size_, n-size_, args...);
+            }
+            else{
+                detail::destroy_n(allocator_, head_+n, size_-n);
+            }
+            size_ = n;
+        }
+        void shrink_to_fit(){
+            if(capacity_ > std::max(size_, Inline)){
+                reallocate(size_);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Views: view.
+        //!               slice.
+        //!               subarray.
+        //!               reshape.
+        //! @note  None of these allocate nor copy: see dynarray_view<T, N>. Views of an inline array are invalidated
+        //!        when the array is moved.
+        //!
+        dynarray_view<T> view() noexcept{
+            return dynarray_view<T>(head_, {size_});
+        }
+        dynarray_view<const T> view() const noexcept{
+            return dynarray_view<const T>(head_, {size_});
+        }
+        dynarray_view<T> slice(size_t first, size_t n, size_t step = 1U){
+            return view().slice(0U, first, n, step);
+        }
+        dynarray_view<const T> slice(size_t first, size_t n, size_t step = 1U) const{
+            return view().slice(0U, first, n, step);
+        }
+        dynarray_view<T> subarray(size_t offset, size_t n){
+            return view().subarray({offset}, {n});
+        }
+        dynarray_view<const T> subarray(size_t offset, size_t n) const{
+            return view().subarray({offset}, {n});
+        }
+        template<typename ... Idx>
+        dynarray_view<T, sizeof ... (Idx)> reshape(Idx ... n){
+            return view().reshape(n...);
+        }
+        template<typename ... Idx>
+        dynarray_view<const T, sizeof ... (Idx)> reshape(Idx ... n) const{
+            return view().reshape(n...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: fill.
+        //!                    swap.
+        //!                    get_allocator.
+        //!
+        void fill(const_type_v& value) noexcept{
+            detail::fill_n(head_, size_, value);
+        }
+        friend void swap(small_dynarray& lhs, small_dynarray& rhs) noexcept(std::is_nothrow_move_constructible_v<T>){
+            if(!lhs.is_inline() && !rhs.is_inline()){
+                std::swap(lhs.allocator_, rhs.allocator_);
+                std::swap(lhs.head_, rhs.head_);
+                std::swap(lhs.size_, rhs.size_);
+                std::swap(lhs.capacity_, rhs.capacity_);
+            }
+            else{
+                small_dynarray t(std::move(lhs));
+                lhs = std::move(rhs);
+                rhs = std::move(t);
+            }
+        }
+        type_a get_allocator() const noexcept{
+            return allocator_;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator<< .
+        //!                              operator== .
+        //!                              operator!= .
+        //!
+        friend std::ostream& operator<<(std::ostream& o, const small_dynarray& other) noexcept{
+            o << "[";
+            for(size_t i = 0U; i < other.size(); ++i){
+                if(i < other.size()-1U){
+                    o << other[i] << " ";
+                }
+                else{
+                    o << other[i];
+                }
+            }
+            return o << "]";
+        }
+        friend bool operator==(const small_dynarray& lhs, const small_dynarray& rhs){
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+        friend bool operator!=(const small_dynarray& lhs, const small_dynarray& rhs){
+            return !(lhs == rhs);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (empty, inline, w/ allocator).
+        //!
+        explicit small_dynarray(type_a&& allocator) noexcept : size_(0U), capacity_(Inline),
+                                                               allocator_(std::move(allocator)), head_(buffer()){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Inline storage.
+        //!
+        type_p buffer() noexcept{
+            return static_cast<type_p>(static_cast<void*>(buffer_));
+        }
+        const_type_p buffer() const noexcept{
+            return static_cast<const_type_p>(static_cast<const void*>(buffer_));
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Move the (constructed) elements to new storage of capacity elements (inline if capacity <= Inline).
+        //!
+        void reallocate(size_t capacity){
+            capacity = std::max(capacity, Inline);
+            type_p head = capacity == Inline ? buffer() : allocator_.allocate(capacity);
+            if(head == head_){
+                return;
+            }
+            try{
+                detail::relocate_n(allocator_, head_, size_, head);
+            }
+            catch(...){
+                if(head != buffer()){
+                    allocator_.deallocate(head, capacity);
+                }
+                throw;
+            }
+            if(!is_inline()){
+                allocator_.deallocate(head_, capacity_);
+            }
+            // Initialise...
+            capacity_ = capacity;
+            head_     = head;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destroy the elements and release the heap storage (if any), leaving an empty inline array.
+        //!
+        void release() noexcept{
+            detail::destroy_n(allocator_, head_, size_);
+            if(!is_inline()){
+                allocator_.deallocate(head_, capacity_);
+            }
+            // Initialise...
+            size_     = 0U;
+            capacity_ = Inline;
+            head_     = buffer();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Take the elements of other (empty inline *this), leaving other empty.
+        //!
+        void steal(small_dynarray& other) noexcept(std::is_nothrow_move_constructible_v<T>){
+            if(other.is_inline()){
+                detail::relocate_n(allocator_, other.head_, other.size_, head_);
+                size_       = other.size_;
+                other.size_ = 0U;
+            }
+            else{
+                size_           = other.size_;
+                capacity_       = other.capacity_;
+                head_           = other.head_;
+                other.size_     = 0U;
+                other.capacity_ = Inline;
+                other.head_     = other.buffer();
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
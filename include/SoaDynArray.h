@@ -0,0 +1,379 @@
+/**
+ * @file    SoaDynArray.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Structure-of-arrays (one column per field) N-D dynamic array template.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_SOADYNARRAY_H
+#define DYNARRAY_SOADYNARRAY_H
+
+#include<algorithm>
+#include<array>
+#include<iostream>
+#include<limits>
+#include<memory>
+#include<stdexcept>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+
+#include "Auxiliary.h"
+#include "DynArrayView.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Structure-of-arrays N-D (dynamic) array template (see soa_dynarray<std::tuple<F ...>, N, A>).
+    //!
+    template<typename S, size_t N = 1U, template<typename U> typename A = std::allocator>
+    class soa_dynarray;
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Structure-of-arrays N-D (dynamic) array template w/ fields F ....
+    //! @note  Example: vla::soa_dynarray<std::tuple<double, double, double>, 3> a(nx, ny, nz) : 3 fields (columns).
+    //!                 a.field<1>()                 : nx x ny x nz view of field 1 (unit-stride, 64-byte aligned).
+    //!                 auto [r, u, p] = a(i, j, k)  : references to the fields of record (i, j, k).
+    //!                 a(i, j, k) = {1.0, 0.0, 1e5} : record assignment.
+    //!        Each field is stored as its own contiguous (row-major) column, all columns sharing the extents and a
+    //!        single allocation, each column starting on a column_alignment-byte boundary. Hence, kernels reading a
+    //!        single field stream only that field's bytes. Records are accessed through std::tuple<F& ...> proxies.
+    //!
+    template<typename ... F, size_t N, template<typename U> typename A>
+    class soa_dynarray<std::tuple<F ...>, N, A>{
+        static_assert(N > 0U && sizeof ... (F) > 0U, "soa_dynarray<std::tuple<F ...>, N, A>: N and F ... must be set.");
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member constants.
+        //!
+        static constexpr size_t fields           = sizeof ... (F); //!<Number of fields.
+        static constexpr size_t column_alignment = 64U;            //!<Bytes.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        template<size_t I>
+        using field_type      = std::tuple_element_t<I, std::tuple<F ...>>; //!<Type of field I.
+        using value_type      = std::tuple<F ...>;                          //!<Record.
+        using reference       = std::tuple<F& ...>;                         //!<Record (proxy).
+        using const_reference = std::tuple<const F& ...>;                   //!<Record (constant proxy).
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Storage block (column_alignment bytes).
+        //!
+        struct alignas(column_alignment) block{
+            unsigned char bytes[column_alignment];
+        };
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using       type_b =       block;                         //!<         Type block      alias.
+        using       type_p =       type_b*;                       //!<         Type pointer    alias.
+        using       type_a =     A<type_b>;                       //!<         Type allocator  alias.
+        using       TYPE_E =       std::array<size_t, N>;         //!<         Type extents    alias.
+        using       TYPE_C =       std::array<size_t, fields+1U>; //!<         Type columns    alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        size_t                       size_;      //!<Type              size (records).
+        TYPE_E                       extents_;   //!<Type              extents.        //!<n(0), n(1), n(2), ...
+        TYPE_E                       strides_;   //!<Type              strides.        //!<s(0), s(1), s(2), ...
+        TYPE_C                       columns_;   //!<Type              column offsets. //!<Blocks, c(fields) = capacity.
+        [[no_unique_address]] type_a allocator_; //!<Type              allocator.
+        type_p                       data_;      //!<Type (pointer to) data (content).
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::soa_dynarray<std::tuple<double, int>> a
+        //!
+        soa_dynarray() noexcept : size_(0U), extents_{}, strides_{}, columns_{}, data_(nullptr){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::soa_dynarray<std::tuple<double, int>, 2> a(4U, 5U) : 4x5 records (value-initialised).
+        //!
+        template<typename ... Idx> requires(1U+sizeof ... (Idx) == N)
+        explicit soa_dynarray(size_t n, Idx ... m) : soa_dynarray(){
+            allocate({n, detail::index(m)...});
+            construct(std::index_sequence_for<F ...>{}, [](auto& a, auto* p, size_t k, size_t){
+                detail::construct_n(a, p, k);
+            });
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Copy/move constructors and assignment (copy-and-swap).
+        //!
+        soa_dynarray(const soa_dynarray& other) :
+            size_(0U), extents_{}, strides_{}, columns_{},
+            allocator_(std::allocator_traits<type_a>::select_on_container_copy_construction(other.allocator_)),
+            data_(nullptr){
+            allocate(other.extents_);
+            construct(std::index_sequence_for<F ...>{}, [&other](auto& a, auto* p, size_t k, size_t i){
+                using T = std::remove_pointer_t<decltype(p)>;
+                detail::copy_n(a, static_cast<const T*>(static_cast<const void*>(other.data_+other.columns_[i])), k, p);
+            });
+        }
+        soa_dynarray(soa_dynarray&& other) noexcept : soa_dynarray(){
+            swap(*this, other);
+        }
+        soa_dynarray& operator=(soa_dynarray other) noexcept{
+            swap(*this, other);
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Destructor.
+        //!
+        ~soa_dynarray() noexcept{
+            destroy(std::index_sequence_for<F ...>{});
+            if(data_ != nullptr){
+                allocator_.deallocate(data_, columns_[fields]);
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: field (N-D view of field I).
+        //!                        data  (pointer to field I).
+        //!                        at.
+        //!                        operator() (record (i(0), i(1), ...)).
+        //!                        row        (record i, in row-major order).
+        //!
+        template<size_t I>
+        dynarray_view<field_type<I>, N> field() noexcept{
+            return dynarray_view<field_type<I>, N>(data<I>(), extents_);
+        }
+        template<size_t I>
+        dynarray_view<const field_type<I>, N> field() const noexcept{
+            return dynarray_view<const field_type<I>, N>(data<I>(), extents_);
+        }
+        template<size_t I>
+        field_type<I>* data() noexcept{
+            return static_cast<field_type<I>*>(static_cast<void*>(data_+columns_[I]));
+        }
+        template<size_t I>
+        const field_type<I>* data() const noexcept{
+            return static_cast<const field_type<I>*>(static_cast<const void*>(data_+columns_[I]));
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        reference at(Idx ... idx){
+            if(!in_range(idx...)){
+                throw std::out_of_range("soa_dynarray<std::tuple<F ...>, N, A>::at(Idx ...)");
+            }
+            return row(offset(idx...));
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_reference at(Idx ... idx) const{
+            if(!in_range(idx...)){
+                throw std::out_of_range("soa_dynarray<std::tuple<F ...>, N, A>::at(Idx ...) const");
+            }
+            return row(offset(idx...));
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        reference operator()(Idx ... idx) noexcept{
+            return row(offset(idx...));
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_reference operator()(Idx ... idx) const noexcept{
+            return row(offset(idx...));
+        }
+        reference row(size_t i) noexcept{
+            return row(i, std::index_sequence_for<F ...>{});
+        }
+        const_reference row(size_t i) const noexcept{
+            return row(i, std::index_sequence_for<F ...>{});
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: empty.
+        //!                  size (records).
+        //!                  rank.
+        //!                  extent.
+        //!                  extents.
+        //!                  stride.
+        //!
+        bool empty() const noexcept{
+            return size_ == 0U;
+        }
+        size_t size() const noexcept{
+            return size_;
+        }
+        static constexpr size_t rank() noexcept{
+            return N;
+        }
+        size_t extent(size_t k) const noexcept{
+            return extents_[k];
+        }
+        const TYPE_E& extents() const noexcept{
+            return extents_;
+        }
+        size_t stride(size_t k) const noexcept{
+            return strides_[k];
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Memory footprint: payload_bytes.
+        //!                          metadata_bytes.
+        //!                          allocation_count.
+        //! @note  payload_bytes() is the size of the allocated storage (incl. column alignment padding),
+        //!        metadata_bytes() the size of the array object itself. allocation_count() is only available w/ a
+        //!        counting allocator (see vla::counting_allocator).
+        //!
+        size_t payload_bytes() const noexcept{
+            return columns_[fields]*sizeof(type_b);
+        }
+        size_t metadata_bytes() const noexcept{
+            return sizeof(soa_dynarray);
+        }
+        size_t allocation_count() const noexcept requires(requires(const type_a& a){a.allocation_count();}){
+            return allocator_.allocation_count();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: fill (every record).
+        //!                    swap.
+        //!
+        void fill(const value_type& value){
+            fill(value, std::index_sequence_for<F ...>{});
+        }
+        friend void swap(soa_dynarray& lhs, soa_dynarray& rhs) noexcept{
+            std::swap(lhs.allocator_, rhs.allocator_);
+            std::swap(lhs.data_, rhs.data_);
+            std::swap(lhs.size_, rhs.size_);
+            std::swap(lhs.extents_, rhs.extents_);
+            std::swap(lhs.strides_, rhs.strides_);
+            std::swap(lhs.columns_, rhs.columns_);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Non-member functions: operator<< (records, in row-major order).
+        //!                              operator== .
+        //!                              operator!= .
+        //!
+        friend std::ostream& operator<<(std::ostream& o, const soa_dynarray& other) noexcept{
+            o << "[";
+            for(size_t i = 0U; i < other.size(); ++i){
+                o << "(";
+                std::apply([&o](const auto& x0, const auto& ... x){
+                    o << x0;
+                    ((o << " " << x), ...);
+                }, other.row(i));
+                o << (i < other.size()-1U ? ") " : ")");
+            }
+            return o << "]";
+        }
+        friend bool operator==(const soa_dynarray& lhs, const soa_dynarray& rhs){
+            if(lhs.extents_ != rhs.extents_){
+                return false;
+            }
+            return [&]<size_t ... I>(std::index_sequence<I ...>){
+                return (std::equal(lhs.template data<I>(), lhs.template data<I>()+lhs.size_,
+                                   rhs.template data<I>()) && ...);
+            }(std::index_sequence_for<F ...>{});
+        }
+        friend bool operator!=(const soa_dynarray& lhs, const soa_dynarray& rhs){
+            return !(lhs == rhs);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Initialise extents, strides, size and column offsets, and allocate the (single) storage block.
+        //!
+        void allocate(const TYPE_E& extents){
+            // Initialise...
+            extents_ = extents;
+            size_    = 1U;
+            for(size_t k = N; k > 0U; --k){
+                strides_[k-1U] = size_;
+                size_         *= extents_[k-1U];
+            }
+            constexpr std::array<size_t, fields> bytes = {sizeof(F)...};
+            columns_[0U] = 0U;
+            for(size_t i = 0U; i < fields; ++i){
+                if(size_ > (std::numeric_limits<size_t>::max()-sizeof(type_b))/bytes[i]){
+                    throw std::invalid_argument("soa_dynarray<std::tuple<F ...>, N, A>::allocate(const TYPE_E&)");
+                }
+                columns_[i+1U] = columns_[i]+(size_*bytes[i]+sizeof(type_b)-1U)/sizeof(type_b);
+            }
+            data_ = columns_[fields] == 0U ? nullptr : allocator_.allocate(columns_[fields]);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Construct column I w/ f(allocator, p, size, I), for each I (the columns constructed so far are
+        //!        destroyed and the storage released if f throws).
+        //!
+        template<size_t ... I, typename G>
+        void construct(std::index_sequence<I ...>, G f){
+            size_t done = 0U;
+            try{
+                ((f(allocator_, data<I>(), size_, I), ++done), ...);
+            }
+            catch(...){
+                ((I < done ? detail::destroy_n(allocator_, data<I>(), size_) : void()), ...);
+                if(data_ != nullptr){
+                    allocator_.deallocate(data_, columns_[fields]);
+                }
+                data_ = nullptr;
+                size_ = 0U;
+                throw;
+            }
+        }
+        template<size_t ... I>
+        void destroy(std::index_sequence<I ...>) noexcept{
+            if(data_ != nullptr){
+                (detail::destroy_n(allocator_, data<I>(), size_), ...);
+            }
+        }
+        template<size_t ... I>
+        void fill(const value_type& value, std::index_sequence<I ...>){
+            (detail::fill_n(data<I>(), size_, std::get<I>(value)), ...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Record i.
+        //!
+        template<size_t ... I>
+        reference row(size_t i, std::index_sequence<I ...>) noexcept{
+            return reference(data<I>()[i]...);
+        }
+        template<size_t ... I>
+        const_reference row(size_t i, std::index_sequence<I ...>) const noexcept{
+            return const_reference(data<I>()[i]...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Offset of record (i(0), i(1), ...).
+        //!
+        template<typename ... Idx>
+        size_t offset(Idx ... idx) const noexcept{
+            size_t k = 0U, o = 0U;
+            ((o += detail::index(idx)*strides_[k++]), ...);
+            return o;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether record (i(0), i(1), ...) is within bounds.
+        //!
+        template<typename ... Idx>
+        bool in_range(Idx ... idx) const noexcept{
+            size_t k = 0U;
+            return ((detail::index(idx) < extents_[k++]) && ...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
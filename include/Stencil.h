@@ -0,0 +1,436 @@
+/**
+ * @file    Stencil.h
+ * @author  Filipe Forte Tenreiro <filipe.tenreiro1@gmail.com>
+ * @brief   Ghost-cell (halo) arrays, halo pack/unpack and stencil application.
+ * @version 0.1
+ * @date    march 2024
+ */
+
+#ifndef DYNARRAY_STENCIL_H
+#define DYNARRAY_STENCIL_H
+
+#include<algorithm>
+#include<array>
+#include<stdexcept>
+#include<tuple>
+#include<utility>
+
+#include "Auxiliary.h"
+#include "DynArray.h"
+#include "DynArrayView.h"
+#include "Expression.h"
+#include "Layout.h"
+#include "Parallel.h"
+
+namespace vla{
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Halo (ghost-cell layer) width tag.
+    //! @note  Example: vla::halo_array<double, 3> a(vla::halo_width{2}, nx, ny, nz) : 2 ghost layers on each side.
+    //!
+    struct halo_width{
+        size_t width;
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief N-D (dynamic) array template w/ ghost-cell layers (halo) of width h around the interior.
+    //! @note  Example: vla::halo_array<double, 3> a(vla::halo_width{1}, nx, ny, nz)
+    //!                 a(i, j, k)       : interior element (i, j, k), i.e. element (i+h, j+h, k+h) of the buffer.
+    //!                 a.view()         : (n(0)+2h)x(n(1)+2h)x... view of the whole buffer (ghosts incl.).
+    //!                 a.ghost(0, 1)    : ghost layer past the last interior plane along dimension 0.
+    //!                 a.boundary(0, 1) : last h interior planes along dimension 0 (sent to the neighbour's ghost).
+    //!        Interior and ghosts share a single (row-major) buffer, hence neighbours of an interior element are at
+    //!        fixed offsets (see stencil_point<T, N>). The array itself behaves as its interior, e.g. in expressions,
+    //!        parallel algorithms and when converted to a view.
+    //!
+    template<typename T, size_t N = 1U, template<typename U> typename A = std::allocator>
+    class halo_array{
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Type aliases.
+        //!
+        using       type_v =       T;                       //!<         Type value      alias.
+        using const_type_v = const T;                       //!<Constant type value      alias.
+        using       type_p =       type_v*;                 //!<         Type pointer    alias.
+        using const_type_p = const type_v*;                 //!<Constant type pointer    alias.
+        using       type_r =       type_v&;                 //!<         Type reference  alias.
+        using const_type_r = const type_v&;                 //!<Constant type reference  alias.
+        using       TYPE_E =       std::array<size_t, N>;   //!<         Type extents    alias.
+        using       TYPE_D =       dynarray<T, N, A>;       //!<         Type buffer     alias.
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Member variables.
+        //!
+        size_t halo_;    //!<Halo width.
+        TYPE_E extents_; //!<Interior extents. //!<n(0), n(1), n(2), ...
+        TYPE_D data_;    //!<Buffer.           //!<n(0)+2h, n(1)+2h, n(2)+2h, ...
+        //--------------------------------------------------------------------------------------------------------------
+    public:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor.
+        //! @note  Example: vla::halo_array<double, 2> a(vla::halo_width{1}, 4U, 5U)      : 4x5 interior, filled w/ 0's.
+        //!                 vla::halo_array<double, 2> a(vla::halo_width{1}, 4U, 5U, 1.0) : idem, filled w/ 1's.
+        //!        The N arguments following the halo width are the interior extents, the remaining ones are forwarded
+        //!        to each element's constructor (ghosts incl.).
+        //!
+        halo_array() : halo_(0U), extents_{}, data_(){
+        }
+        template<typename ... Args> requires(1U+sizeof ... (Args) >= N)
+        explicit halo_array(halo_width h, size_t n, const Args& ... args) :
+            halo_array(h.width, std::forward_as_tuple(n, args...), std::make_index_sequence<N>{},
+                       std::make_index_sequence<1U+sizeof ... (Args)-N>{}){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Expression assignment (interior only). See expression<E> (Expression.h).
+        //!
+        template<typename E>
+        halo_array& operator=(const expression<E>& e){
+            interior() = e;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<halo_array, X>)
+        halo_array& operator+=(const X& x){
+            interior() += x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<halo_array, X>)
+        halo_array& operator-=(const X& x){
+            interior() -= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<halo_array, X>)
+        halo_array& operator*=(const X& x){
+            interior() *= x;
+            return *this;
+        }
+        template<typename X> requires(detail::is_operand_v<halo_array, X>)
+        halo_array& operator/=(const X& x){
+            interior() /= x;
+            return *this;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Element access: at.
+        //!                        operator().
+        //!                        data (interior origin, i.e. element (0, 0, ...)).
+        //!
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        type_r at(Idx ... idx){
+            if(!in_range(idx...)){
+                throw std::out_of_range("halo_array<T, N, A>::at(Idx ...)");
+            }
+            return (*this)(idx...);
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_type_r at(Idx ... idx) const{
+            if(!in_range(idx...)){
+                throw std::out_of_range("halo_array<T, N, A>::at(Idx ...) const");
+            }
+            return (*this)(idx...);
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        type_r operator()(Idx ... idx) noexcept{
+            return data_((detail::index(idx)+halo_)...);
+        }
+        template<typename ... Idx> requires(sizeof ... (Idx) == N)
+        const_type_r operator()(Idx ... idx) const noexcept{
+            return data_((detail::index(idx)+halo_)...);
+        }
+        type_p data() noexcept{
+            return data_.data()+origin();
+        }
+        const_type_p data() const noexcept{
+            return data_.data()+origin();
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Capacity: empty.
+        //!                  size.
+        //!                  halo.
+        //!                  extent.
+        //!                  extents.
+        //!                  stride.
+        //! @note  Extents and size are the interior ones, strides are the buffer ones.
+        //!
+        bool empty() const noexcept{
+            return size() == 0U;
+        }
+        size_t size() const noexcept{
+            size_t n = 1U;
+            for(size_t k = 0U; k < N; ++k){
+                n *= extents_[k];
+            }
+            return n;
+        }
+        size_t halo() const noexcept{
+            return halo_;
+        }
+        size_t extent(size_t k) const noexcept{
+            return extents_[k];
+        }
+        const TYPE_E& extents() const noexcept{
+            return extents_;
+        }
+        size_t stride(size_t k) const noexcept{
+            return data_.stride(k);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Views: view     (whole buffer).
+        //!               interior.
+        //!               ghost    (ghost layer of dimension k, before (side = 0) or past (side = 1) the interior).
+        //!               boundary (interior layer of dimension k adjacent to ghost(k, side)).
+        //! @note  Ghost and boundary layers span the interior along the other dimensions (corners are excluded).
+        //!
+        dynarray_view<T, N> view() noexcept{
+            return data_.view();
+        }
+        dynarray_view<const T, N> view() const noexcept{
+            return data_.view();
+        }
+        dynarray_view<T, N> interior() noexcept{
+            return view().subarray(offsets(), extents_);
+        }
+        dynarray_view<const T, N> interior() const noexcept{
+            return view().subarray(offsets(), extents_);
+        }
+        dynarray_view<T, N> ghost(size_t k, size_t side){
+            return layer(view(), k, side, side == 0U ? 0U : halo_+extents_[k]);
+        }
+        dynarray_view<const T, N> ghost(size_t k, size_t side) const{
+            return layer(view(), k, side, side == 0U ? 0U : halo_+extents_[k]);
+        }
+        dynarray_view<T, N> boundary(size_t k, size_t side){
+            return layer(view(), k, side, side == 0U ? halo_ : extents_[k]);
+        }
+        dynarray_view<const T, N> boundary(size_t k, size_t side) const{
+            return layer(view(), k, side, side == 0U ? halo_ : extents_[k]);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Operations: fill (ghosts incl.).
+        //!                    swap.
+        //!
+        void fill(const_type_v& value){
+            data_.fill(value);
+        }
+        friend void swap(halo_array& lhs, halo_array& rhs) noexcept{
+            std::swap(lhs.halo_, rhs.halo_);
+            std::swap(lhs.extents_, rhs.extents_);
+            swap(lhs.data_, rhs.data_);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    private:
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Auxiliary functions.
+        //!
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Constructor (split the (input) arguments into interior extents and element arguments).
+        //!
+        template<typename Tuple, size_t ... I, size_t ... J>
+        halo_array(size_t h, const Tuple& args, std::index_sequence<I ...>, std::index_sequence<J ...>) :
+            halo_(h), extents_{detail::index(std::get<I>(args))...},
+            data_((detail::index(std::get<I>(args))+2U*h)..., std::get<N+J>(args)...){
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Offsets (h, h, ...) and offset of the interior origin w.r.t. the buffer.
+        //!
+        TYPE_E offsets() const noexcept{
+            TYPE_E o;
+            o.fill(halo_);
+            return o;
+        }
+        size_t origin() const noexcept{
+            size_t o = 0U;
+            for(size_t k = 0U; k < N; ++k){
+                o += halo_*data_.stride(k);
+            }
+            return o;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Layer of width h along dimension k starting at (buffer) index first.
+        //!
+        template<typename V>
+        V layer(V v, size_t k, size_t side, size_t first) const{
+            if(k >= N || side > 1U){
+                throw std::out_of_range("halo_array<T, N, A>::layer(size_t, size_t)");
+            }
+            TYPE_E o = offsets(), n = extents_;
+            o[k] = first;
+            n[k] = halo_;
+            return v.subarray(o, n);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Check whether (interior) element (i(0), i(1), ...) is within bounds.
+        //!
+        template<typename ... Idx>
+        bool in_range(Idx ... idx) const noexcept{
+            size_t k = 0U;
+            return ((detail::index(idx) < extents_[k++]) && ...);
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Stencil point: neighbourhood of an element (passed to stencil_apply kernels).
+    //! @note  Example: [](const auto& u){return u(-1, 0)+u(1, 0)+u(0, -1)+u(0, 1)-4.0*u(0, 0);} : 2-D Laplacian.
+    //!        u(d(0), d(1), ...) is the element at (signed) offset d from the centre, i.e. at a fixed distance in
+    //!        memory (no bounds check: the halo must be at least as wide as the stencil).
+    //!
+    template<typename T, size_t N>
+    class stencil_point{
+    private:
+        T*                    centre_;  //!<Centre.
+        std::array<size_d, N> strides_; //!<Strides.
+    public:
+        constexpr stencil_point(T* centre, const std::array<size_d, N>& strides) noexcept : centre_(centre),
+                                                                                           strides_(strides){
+        }
+        template<typename ... Off> requires(sizeof ... (Off) == N)
+        constexpr T& operator()(Off ... off) const noexcept{
+            size_t k = 0U;
+            size_d d = 0;
+            ((d += detail::convert<size_d>(off)*strides_[k++]), ...);
+            return *(centre_+d);
+        }
+    };
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Auxiliary functions.
+    //!
+    namespace detail{
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Cache block (elements) of stencil_apply: rows of the second innermost dimension are processed in
+        //!        blocks of ~stencil_block elements, so that the planes a stencil reaches stay in cache.
+        //!
+        inline constexpr size_t stencil_block = 16384U;
+        //--------------------------------------------------------------------------------------------------------------
+        //!
+        //! @brief Apply kernel f to outermost indices [first, last) of in, writing out.
+        //!
+        template<typename U, typename T, size_t N, typename F>
+        void stencil_rows(const dynarray_view<U, N>& out, const dynarray_view<const T, N>& in, F& f, size_t first,
+                          size_t last){
+            std::array<size_d, N> s{};
+            for(size_t k = 0U; k < N; ++k){
+                s[k] = convert<size_d>(in.stride(k));
+            }
+            const size_t so = out.stride(N-1U), si = in.stride(N-1U);
+            const auto   row = [&](U* o, const T* c, size_t n){
+                if(so == 1U && si == 1U){
+                    for(size_t j = 0U; j < n; ++j){
+                        o[j] = f(stencil_point<const T, N>(c+j, s));
+                    }
+                }
+                else{
+                    for(size_t j = 0U; j < n; ++j){
+                        o[j*so] = f(stencil_point<const T, N>(c+j*si, s));
+                    }
+                }
+            };
+            if constexpr(N == 1U){
+                row(out.data()+first*so, in.data()+first*si, last-first);
+            }
+            else{
+                constexpr size_t M = N-1U;
+                std::array<size_t, M> lo{}, hi{};
+                for(size_t k = 0U; k < M; ++k){
+                    hi[k] = in.extent(k);
+                }
+                lo[0U] = first;
+                hi[0U] = last;
+                const size_t n = in.extent(M);
+                const size_t b = std::max<size_t>(stencil_block/std::max<size_t>(n, 1U), 1U);
+                for(size_t jb = lo[M-1U]; jb < hi[M-1U]; jb += b){
+                    std::array<size_t, M> l = lo, h = hi;
+                    l[M-1U] = jb;
+                    h[M-1U] = std::min(jb+b, hi[M-1U]);
+                    for_each_index(l, h, order<M>(false), [&](const std::array<size_t, M>& i){
+                        size_t po = 0U, pi = 0U;
+                        for(size_t k = 0U; k < M; ++k){
+                            po += i[k]*out.stride(k);
+                            pi += i[k]*in.stride(k);
+                        }
+                        row(out.data()+po, in.data()+pi, n);
+                    });
+                }
+            }
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Stencil application: out(i) = f(u), where u is the stencil point of in at i (see stencil_point<T, N>).
+    //! @note  Example: vla::stencil_apply(b, a, [](const auto& u){return 0.5*(u(-1)+u(1));})
+    //!                 vla::stencil_apply(b, a, f, {.grain = 4U}) : in parallel, 4 outer indices per chunk.
+    //!        in and out may be halo arrays (interiors), arrays or views of the same extents, and must not overlap;
+    //!        the stencil may only reach elements of in's halo. The innermost dimension is swept w/ unit stride (inner
+    //!        loops vectorise if f does) and the second innermost one in cache blocks.
+    //!
+    template<typename X, typename Y, typename F>
+    void stencil_apply(X&& out, const Y& in, F f){
+        const auto vo = detail::view_of(out);
+        const auto vi = detail::view_of(in);
+        if(vo.extents() != vi.extents()){
+            throw std::invalid_argument("vla::stencil_apply(X&&, const Y&, F)");
+        }
+        if(!vi.empty()){
+            detail::stencil_rows(vo, vi, f, 0U, vi.extent(0U));
+        }
+    }
+    template<typename X, typename Y, typename F>
+    void stencil_apply(X&& out, const Y& in, F f, const parallel::policy& p){
+        const auto vo = detail::view_of(out);
+        const auto vi = detail::view_of(in);
+        if(vo.extents() != vi.extents()){
+            throw std::invalid_argument("vla::stencil_apply(X&&, const Y&, F, const parallel::policy&)");
+        }
+        if(!vi.empty()){
+            parallel::policy q = p;
+            q.grain = parallel::detail::grain(p, vi);
+            parallel::for_range(vi.extent(0U), [&](size_t first, size_t last){
+                F g = f;
+                detail::stencil_rows(vo, vi, g, first, last);
+            }, q);
+        }
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    //!
+    //! @brief Halo exchange helpers: pack   (copy view v to contiguous buffer p, in row-major order).
+    //!                               unpack (copy contiguous buffer p to view v, in row-major order).
+    //! @note  Example: std::vector<double> b(a.boundary(0, 1).size());
+    //!                 vla::pack(a.boundary(0, 1), b.data()) : send b to the neighbour past dimension 0...
+    //!                 vla::unpack(b.data(), c.ghost(0, 0))  : ...which receives it in its ghost layer.
+    //!        Both return the number of elements copied.
+    //!
+    template<typename T, size_t N, typename U>
+    size_t pack(const dynarray_view<T, N>& v, U* p){
+        detail::for_each_row([&](size_t n, auto r){
+            for(size_t j = 0U; j < n; ++j){
+                *p++ = r[j];
+            }
+        }, v);
+        return v.size();
+    }
+    template<typename U, typename T, size_t N>
+    size_t unpack(const U* p, const dynarray_view<T, N>& v){
+        detail::for_each_row([&](size_t n, auto r){
+            for(size_t j = 0U; j < n; ++j){
+                r[j] = *p++;
+            }
+        }, v);
+        return v.size();
+    }
+    //------------------------------------------------------------------------------------------------------------------
+}
+
+#endif
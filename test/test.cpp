@@ -1,6 +1,33 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Accumulation.h"
+#include "Arena.h"
+#include "Compression.h"
 #include "DynArray.h"
+#include "Indirect.h"
+#include "Instrumentation.h"
+#include "MdArray.h"
+#include "Numa.h"
+#include "Numeric.h"
+#include "Parallel.h"
+#include "RaggedDynArray.h"
+#include "Serialization.h"
+#include "SmallDynArray.h"
+#include "SoaDynArray.h"
+#include "Stencil.h"
 
 namespace Test{
     //------------------------------------------------------------------------------------------------------------------
@@ -46,6 +73,190 @@ namespace Test{
         EXPECT_TRUE(b.front() == a.back()); //!<b(0) = 3, a(2) = 3 <=> b(0) = a(2).
         //--------------------------------------------------------------------------------------------------------------
     }
+    TEST(DynArray_1D, T3){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<double> a(vla::uninitialized, 5U);
+        vla::dynarray<double> b(vla::default_init, 5U);
+        vla::dynarray<std::string> c(vla::default_init, 2U);
+        vla::dynarray<char> d(4U, 'a');
+        vla::dynarray<double> e(3U, 0.0);
+        //--------------------------------------------------------------------------------------------------------------
+        a.fill(2.5); b.fill(0.0);
+        d.fill('z');
+        EXPECT_EQ(a[4U], 2.5);
+        EXPECT_EQ(b[4U], 0.0);
+        EXPECT_TRUE(c[1U].empty());
+        EXPECT_EQ(d[3U], 'z');
+        e[1U] = 1.0; vla::dynarray<double> f(e);
+        EXPECT_EQ(f[0U], 0.0); EXPECT_EQ(f[1U], 1.0);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_1D, T4){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<int> a(4U, 1);
+        vla::dynarray<std::string> b(2U, "abc");
+        vla::dynarray<int> c;
+        //--------------------------------------------------------------------------------------------------------------
+        a.reserve(10U);
+        const int* p = a.data();
+        a.resize(10U, 2);                                       //!<Within capacity: no reallocation.
+        EXPECT_EQ(a.data(), p); EXPECT_EQ(a.capacity(), 10U);
+        EXPECT_EQ(a[3U], 1); EXPECT_EQ(a[9U], 2);
+        a.resize(11U);                                          //!<Geometric growth.
+        EXPECT_EQ(a.capacity(), 15U); EXPECT_EQ(a[10U], 0); EXPECT_EQ(a[9U], 2);
+        a.resize(0U);
+        EXPECT_TRUE(a.empty()); EXPECT_EQ(a.begin(), a.end()); EXPECT_EQ(a.capacity(), 15U);
+        a.shrink_to_fit();
+        EXPECT_EQ(a.capacity(), 0U); EXPECT_EQ(a.data(), nullptr);
+        b.resize(5U, std::string(40U, 'x'));                    //!<Non-trivial relocation.
+        b.resize(3U);
+        EXPECT_EQ(b[0U], "abc"); EXPECT_EQ(b[2U], std::string(40U, 'x')); EXPECT_EQ(b.size(), 3U);
+        EXPECT_EQ(c.begin(), c.end());
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<int> d{1, 2, 3, 4, 5, 6};
+        p = d.data();
+        auto e = std::move(d).reshape(2U, 3U);                  //!<O(1): storage is adopted.
+        EXPECT_EQ(e.data(), p); EXPECT_EQ(e(1U, 0U), 4);
+        EXPECT_TRUE(d.empty());
+        auto f = std::move(e).reshape(6U);
+        EXPECT_EQ(f.data(), p); EXPECT_EQ(f[5U], 6);
+        EXPECT_THROW(std::move(f).reshape(4U, 2U), std::invalid_argument);
+        EXPECT_EQ(f.size(), 6U);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_1D, T5){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::small_dynarray<int, 4U> a(3U, 1);
+        vla::small_dynarray<int, 4U> b{1, 2, 3, 4, 5, 6};
+        vla::small_dynarray<std::string, 2U> c(2U, std::string(40U, 'x'));
+        //--------------------------------------------------------------------------------------------------------------
+        EXPECT_TRUE(a.is_inline()); EXPECT_EQ(a.capacity(), 4U);
+        EXPECT_FALSE(b.is_inline()); EXPECT_EQ(b.capacity(), 6U);
+        EXPECT_EQ(b.at(5U), 6); EXPECT_THROW(b.at(6U), std::out_of_range);
+        a.resize(4U, 2);                                        //!<Within inline storage.
+        EXPECT_TRUE(a.is_inline()); EXPECT_EQ(a.back(), 2);
+        a.resize(5U, 3);                                        //!<Spills to the heap.
+        EXPECT_FALSE(a.is_inline()); EXPECT_EQ(a.capacity(), 6U);
+        EXPECT_EQ(a[0U], 1); EXPECT_EQ(a[3U], 2); EXPECT_EQ(a[4U], 3);
+        a.resize(2U);
+        a.shrink_to_fit();                                      //!<Back inline.
+        EXPECT_TRUE(a.is_inline()); EXPECT_EQ(a.size(), 2U); EXPECT_EQ(a[1U], 1);
+        //--------------------------------------------------------------------------------------------------------------
+        const int* p = b.data();
+        vla::small_dynarray<int, 4U> d(std::move(b));           //!<Heap storage is stolen.
+        EXPECT_EQ(d.data(), p); EXPECT_TRUE(b.empty()); EXPECT_TRUE(b.is_inline());
+        vla::small_dynarray<int, 4U> e(a);
+        EXPECT_EQ(e, a); EXPECT_NE(e.data(), a.data());
+        swap(d, e);
+        EXPECT_EQ(e.data(), p); EXPECT_EQ(d.size(), 2U); EXPECT_TRUE(d.is_inline());
+        vla::small_dynarray<std::string, 2U> f(std::move(c));   //!<Inline elements are relocated.
+        EXPECT_TRUE(f.is_inline()); EXPECT_EQ(f[1U], std::string(40U, 'x')); EXPECT_TRUE(c.empty());
+        f = c;
+        EXPECT_TRUE(f.empty());
+        //--------------------------------------------------------------------------------------------------------------
+        std::vector<vla::small_dynarray<int, 4U>> g(3U, vla::small_dynarray<int, 4U>(3U, 7));
+        g.emplace_back(8U, 9);
+        g.resize(100U);                                         //!<Inline and heap elements relocated by the vector.
+        EXPECT_EQ(g[2U][2U], 7); EXPECT_EQ(g[3U][7U], 9); EXPECT_TRUE(g[99U].empty());
+        vla::small_dynarray<double, 4U> h(3U, 1.0);
+        vla::small_dynarray<double, 4U> i(3U, 2.0);
+        h = 2.0*h+i;
+        h += i;
+        EXPECT_EQ(h[2U], 6.0);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_1D, T6){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::ragged_dynarray<int> a{{1, 2}, {3}, {}, {4, 5, 6}};
+        vla::ragged_dynarray<int> b(std::vector<size_t>{2U, 1U, 0U, 3U}, 7);
+        //--------------------------------------------------------------------------------------------------------------
+        EXPECT_EQ(a.rows(), 4U); EXPECT_EQ(a.size(), 6U); EXPECT_EQ(a.size(3U), 3U); EXPECT_TRUE(a[2U].empty());
+        EXPECT_EQ(a[3U][1U], 5); EXPECT_EQ(a(1U, 0U), 3); EXPECT_EQ(&a(3U, 0U), a.data()+3);  //!<Single buffer.
+        EXPECT_EQ(a.offsets()[4U], 6U); EXPECT_EQ(b(3U, 2U), 7);
+        EXPECT_THROW(a.at(4U), std::out_of_range);
+        EXPECT_THROW(a.at(1U, 1U), std::out_of_range);
+        int sum = 0;
+        for(int x : a){
+            sum += x;
+        }
+        EXPECT_EQ(sum, 21);
+        std::stringstream ss;
+        ss << a;
+        EXPECT_EQ(ss.str(), "[[1 2] [3] [] [4 5 6]]");
+        EXPECT_NE(a, b);
+        b.fill(0);
+        b[0U] = a[0U]+0;
+        EXPECT_EQ(b(0U, 1U), 2);
+        //--------------------------------------------------------------------------------------------------------------
+        const auto count = [](size_t i){return i%3U;};
+        const auto fill  = [](size_t i, auto r){
+            for(size_t j = 0U; j < r.size(); ++j){
+                r[j] = static_cast<int>(10U*i+j);
+            }
+        };
+        const auto c = vla::ragged_dynarray<int>::build(1000U, count, fill);
+        const auto d = vla::ragged_dynarray<int>::build(1000U, count, fill, {.grain = 7U});
+        EXPECT_EQ(c.size(), 999U); EXPECT_EQ(c(998U, 1U), 9981); EXPECT_EQ(c, d);
+        EXPECT_THROW((vla::ragged_dynarray<int>(vla::dynarray<size_t>{0U, 2U}, vla::dynarray<int>(1U))),
+                     std::invalid_argument);
+        //--------------------------------------------------------------------------------------------------------------
+        const auto path = std::filesystem::temp_directory_path()/"DynArray_1D_T6.bin";
+        vla::save(path, a);
+        EXPECT_EQ(vla::load_ragged<int>(path), a);
+        std::filesystem::remove(path);
+        std::filesystem::remove(vla::detail::offsets_path(path));
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_1D, T7){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<double> a(1000U);
+        vla::dynarray<float> b(1000U);
+        vla::dynarray<size_t> k(777U);
+        vla::dynarray<int> l({4, 0, 4, 2});
+        //--------------------------------------------------------------------------------------------------------------
+        for(size_t i = 0U; i < a.size(); ++i){
+            a[i] = static_cast<double>(i);
+            b[i] = static_cast<float>(i);
+        }
+        for(size_t i = 0U; i < k.size(); ++i){
+            k[i] = (i*379U)%1000U;                              //!<Distinct indices.
+        }
+        const auto previous = vla::numeric::current_isa();
+        for(auto isa : {vla::numeric::isa::baseline, vla::numeric::isa::avx2, vla::numeric::isa::avx512}){
+            vla::numeric::set_isa(isa);
+            vla::dynarray<double> c(k.size());
+            vla::dynarray<float> d(k.size());
+            vla::dynarray<double> e(a.size(), -1.0);
+            vla::gather(a, k, c);
+            vla::gather(b, k, d);
+            vla::scatter(c, k, e);
+            EXPECT_EQ(c[776U], static_cast<double>(k[776U])); EXPECT_EQ(d[5U], static_cast<float>(k[5U]));
+            EXPECT_EQ(vla::numeric::sum(e)+static_cast<double>(a.size()-k.size()), vla::numeric::sum(c));
+            EXPECT_EQ(e[k[123U]], static_cast<double>(k[123U]));
+        }
+        vla::numeric::set_isa(previous);
+        //--------------------------------------------------------------------------------------------------------------
+        vla::parallel::thread_pool p(3U);
+        vla::dynarray<double> f(k.size()), g(a.size());
+        vla::gather(a, k, f, {.grain = 10U, .pool = &p});
+        vla::scatter(f, k, g, {.grain = 10U, .pool = &p});
+        EXPECT_EQ(f[400U], a[k[400U]]); EXPECT_EQ(g[k[400U]], a[k[400U]]);
+        vla::dynarray<double> h(3U);
+        vla::gather(a.view().slice(0U, 0U, 500U, 2U), l.view().slice(0U, 1U, 3U), h); //!<Strided views.
+        EXPECT_EQ(h[0U], 0.0); EXPECT_EQ(h[1U], 8.0); EXPECT_EQ(h[2U], 4.0);
+        vla::dynarray<double> m(5U, 0.0);
+        vla::scatter(vla::dynarray<double>(4U, 1.0), l, m);
+        vla::scatter(vla::dynarray<double>(4U, 1.0), l, m, std::plus<>{}); //!<Duplicates accumulate.
+        EXPECT_EQ(m[4U], 3.0); EXPECT_EQ(m[0U], 2.0); EXPECT_EQ(m[1U], 0.0);
+        EXPECT_THROW(vla::gather(a, k, h), std::invalid_argument);
+        //--------------------------------------------------------------------------------------------------------------
+        const auto q = vla::locality_order(k, 100U);
+        vla::dynarray<size_t> r(k.size());
+        vla::gather(k, q, r);
+        EXPECT_TRUE(std::is_sorted(r.begin(), r.end(), [](size_t x, size_t y){return x/100U < y/100U;}));
+        EXPECT_EQ(vla::locality_order(l, 1U), vla::dynarray<size_t>({1U, 3U, 0U, 2U}));
+        //--------------------------------------------------------------------------------------------------------------
+    }
     //------------------------------------------------------------------------------------------------------------------
     class DynArray_ND : public ::testing::Test{
     };
@@ -55,10 +266,824 @@ namespace Test{
         vla::dynarray<int, 3U> b(1U, 2U, 3U);
         vla::dynarray<int, 3U> c(1U, 2U, 3U, 4);
         //--------------------------------------------------------------------------------------------------------------
-
-
-        std::cout << c[0][1].size() << std::endl;
-
+        EXPECT_TRUE(a.empty());
+        EXPECT_EQ(b.size(), 6U);       //!<1*2*3 = 6.
+        EXPECT_EQ(c[0U].size(), 6U);   //!<2*3   = 6.
+        EXPECT_EQ(c[0U][1U].size(), 3U);
+        EXPECT_EQ(b(0U, 1U, 2U), 0);   //!<b(0, 1, 2) = 0.
+        EXPECT_EQ(c(0U, 1U, 2U), 4);   //!<c(0, 1, 2) = 4.
+        EXPECT_EQ(c[0U][1U][2U], 4);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T2){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<int, 3U> a(2U, 3U, 4U);
+        //--------------------------------------------------------------------------------------------------------------
+        for(size_t i = 0U; i < a.extent(0U); ++i){
+            for(size_t j = 0U; j < a.extent(1U); ++j){
+                for(size_t k = 0U; k < a.extent(2U); ++k){
+                    a(i, j, k) = static_cast<int>(100U*i+10U*j+k);
+                }
+            }
+        }
+        EXPECT_EQ(a.stride(0U), 12U);  //!<3*4 = 12.
+        EXPECT_EQ(a.stride(1U),  4U);
+        EXPECT_EQ(a.stride(2U),  1U);
+        EXPECT_EQ(a(1U, 2U, 3U), 123); EXPECT_EQ(a.at(1U, 2U, 3U), 123);
+        EXPECT_EQ(a[1U][2U][3U], 123); EXPECT_EQ(a.data()[23U], 123);  //!<1*12+2*4+3 = 23.
+        EXPECT_EQ(a.back().front()[1U], 101);
+        EXPECT_THROW(a.at(2U, 0U, 0U), std::out_of_range);
+        EXPECT_THROW(a.at(0U, 0U, 4U), std::out_of_range);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T3){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<int, 3U> a(2U, 3U, 4U, 7);
+        vla::dynarray<int, 3U> b(a);
+        vla::dynarray<int, 3U> c(std::move(b));
+        vla::dynarray<int, 3U> d; d = c;
+        vla::dynarray<int, 3U> e; e = std::move(d);
+        vla::dynarray<std::string, 2U> f(2U, 2U, "x");
+        vla::dynarray<std::string, 2U> g(f);
+        std::vector<vla::dynarray<int, 2U>> h;
+        for(size_t i = 0U; i < 8U; ++i){
+            h.emplace_back(i+1U, 2U, static_cast<int>(i));  //!<Relocation moves the arrays.
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        a(1U, 2U, 3U) = 0;
+        EXPECT_TRUE(b.empty());                                 //!<Moved-from.
+        EXPECT_TRUE(d.empty());
+        EXPECT_EQ(c.extent(2U), 4U); EXPECT_EQ(c(1U, 2U, 3U), 7);
+        EXPECT_EQ(e.extent(2U), 4U); EXPECT_EQ(e(1U, 2U, 3U), 7);
+        EXPECT_NE(e.data(), a.data());
+        EXPECT_EQ(g(1U, 1U), "x");
+        EXPECT_EQ(h[7U].extent(0U), 8U); EXPECT_EQ(h[7U](7U, 1U), 7);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T4){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<int, 3U> a(vla::uninitialized, 2U, 3U, 4U);
+        vla::dynarray<std::string, 2U> b(vla::default_init, 2U, 2U);
+        //--------------------------------------------------------------------------------------------------------------
+        a.fill(-3);
+        EXPECT_EQ(a(1U, 2U, 3U), -3);
+        a.fill(0);
+        EXPECT_EQ(a(1U, 2U, 3U), 0);
+        EXPECT_TRUE(b(1U, 1U).empty());
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T5){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<double, 2U, vla::aligned_allocator> a(3U, 5U, 1.0);
+        vla::dynarray<double, 3U, vla::padded_allocator>  b(2U, 3U, 5U, 1.0);
+        vla::dynarray<double, 3U, vla::padded_allocator>  c(b);
+        //--------------------------------------------------------------------------------------------------------------
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data())%64U, 0U);
+        EXPECT_EQ(a.leading_dimension(), 5U);
+        EXPECT_TRUE(a.is_contiguous());
+        EXPECT_EQ(b.size(), 30U);
+        EXPECT_EQ(b.leading_dimension(), 8U);                  //!<5 doubles padded to 64 bytes.
+        EXPECT_EQ(b.stride(0U), 24U);
+        EXPECT_FALSE(b.is_contiguous());
+        for(size_t i = 0U; i < b.extent(0U); ++i){
+            for(size_t j = 0U; j < b.extent(1U); ++j){
+                EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&b(i, j, 0U))%64U, 0U);
+            }
+        }
+        b(1U, 2U, 4U) = 2.0;
+        EXPECT_EQ(b[1U][2U][4U], 2.0);
+        EXPECT_EQ(c(1U, 2U, 4U), 1.0);
+        EXPECT_THROW(b.reshape(30U), std::invalid_argument);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T6){
+        //--------------------------------------------------------------------------------------------------------------
+        const auto path = std::filesystem::temp_directory_path()/"DynArray_ND_T6.bin";
+        using dynarray_m = vla::dynarray<double, 2U, vla::mapped_allocator>;
+        //--------------------------------------------------------------------------------------------------------------
+        {
+            auto a = dynarray_m::map(path, vla::map_mode::read_write, 300U, 400U);
+            EXPECT_TRUE(a.get_allocator().is_mapped());
+            EXPECT_EQ(std::filesystem::file_size(path), 300U*400U*sizeof(double));
+            a = a.view()*0.0+1.0;
+            a(299U, 399U) = 2.0;
+            a.get_allocator().advise(vla::map_access::sequential);
+            a.get_allocator().flush();
+            auto b = a;                                         //!<Copies are anonymous (private) arrays.
+            b(0U, 0U) = 3.0;
+            EXPECT_FALSE(b.get_allocator().is_mapped());
+            EXPECT_EQ(a(0U, 0U), 1.0);
+        }
+        {
+            const auto a = dynarray_m::map(path, vla::map_mode::read_only, 300U, 400U);
+            auto c = vla::mapped_allocator<double>(path, vla::map_mode::copy_on_write, 119599U*sizeof(double));
+            auto b = vla::dynarray<double, 1U, vla::mapped_allocator>::map(c, 401U);  //!<Last 401 elements.
+            EXPECT_EQ(a(0U, 0U), 1.0); EXPECT_EQ(a(299U, 399U), 2.0);
+            EXPECT_EQ(b[0U], 1.0); EXPECT_EQ(b[400U], 2.0);
+            b[400U] = 4.0;                                      //!<Private: not written back.
+            EXPECT_EQ(a(299U, 399U), 2.0);
+            EXPECT_THROW(dynarray_m::map(path, vla::map_mode::read_only, 301U, 400U), std::system_error);
+        }
+        {
+            auto a = vla::dynarray<double, 1U, vla::mapped_allocator>::map(path, vla::map_mode::read_only, 100U);
+            a.resize(200U, 5.0);                                //!<Detaches (anonymous copy).
+            EXPECT_FALSE(a.get_allocator().is_mapped());
+            a.resize(50U);
+            a.shrink_to_fit();                                  //!<Stays anonymous (file is never re-mapped).
+            a[0U] = 6.0;
+            EXPECT_FALSE(a.get_allocator().is_mapped());
+            EXPECT_EQ(a.size(), 50U); EXPECT_EQ(a[1U], 1.0); EXPECT_EQ(a[0U], 6.0);
+        }
+        {
+            auto a = vla::dynarray<double, 1U, vla::mapped_allocator>::map(path, vla::map_mode::read_write, 10U);
+            a.reserve(20U);
+            a.shrink_to_fit();
+            a[0U] = 7.0;
+            a.get_allocator().flush();
+            EXPECT_EQ(std::filesystem::file_size(path), 300U*400U*sizeof(double));
+            const auto b = vla::dynarray<double, 1U, vla::mapped_allocator>::map(path, vla::map_mode::read_only, 1U);
+            EXPECT_EQ(b[0U], 1.0);                              //!<Not written back.
+        }
+        std::filesystem::remove(path);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T7){
+        //--------------------------------------------------------------------------------------------------------------
+        const auto path = std::filesystem::temp_directory_path()/"DynArray_ND_T7.bin";
+        vla::dynarray<float, 3U> a(4U, 5U, 6U);
+        vla::dynarray<float, 3U, vla::padded_allocator> b(4U, 5U, 6U);
+        vla::dynarray<float, 3U> c(6U, 5U, 4U);
+        for(size_t i = 0U; i < a.size(); ++i){
+            a.data()[i] = static_cast<float>(i)+0.1F;
+        }
+        //--------------------------------------------------------------------------------------------------------------
+        vla::save(path, a);
+        EXPECT_EQ(std::filesystem::file_size(path), 64U+a.size()*sizeof(float));
+        vla::load(path, b);                                     //!<Padded rows.
+        EXPECT_EQ(b(3U, 4U, 5U), a(3U, 4U, 5U));
+        auto d = vla::load<float, 3U>(path);
+        EXPECT_EQ(d.extents(), a.extents()); EXPECT_EQ(d(1U, 2U, 3U), a(1U, 2U, 3U));
+        auto e = vla::load_mapped<float, 3U>(path);             //!<Zero-copy.
+        EXPECT_EQ(e(2U, 3U, 4U), a(2U, 3U, 4U));
+        EXPECT_THROW((vla::load<double, 3U>(path)), std::invalid_argument);
+        EXPECT_THROW((vla::load<float, 2U>(path)), std::invalid_argument);
+        EXPECT_THROW(vla::load(path, c), std::invalid_argument);
+        //--------------------------------------------------------------------------------------------------------------
+        vla::save(path, b.transpose());                         //!<Element-wise (strided) blocks.
+        vla::load(path, c);
+        EXPECT_EQ(c(5U, 4U, 3U), a(3U, 4U, 5U));
+        {
+            vla::binary_writer<float, 3U> w(path, {4U, 5U, 6U});
+            w.write(a.slice(0U, 0U, 3U));                       //!<Chunks of 3 and 1 outermost indices.
+            w.write(b.slice(0U, 3U, 1U));
+            w.close();
+        }
+        vla::binary_reader<float, 3U> r(path);
+        vla::dynarray<float, 3U> f(1U, 5U, 6U);
+        while(r.remaining() > 1U){
+            r.read(f);
+        }
+        r.read(f);
+        EXPECT_EQ(f(0U, 4U, 5U), a(3U, 4U, 5U));
+        EXPECT_THROW(r.read(f), std::invalid_argument);
+        std::filesystem::remove(path);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T8){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<double, 2U> a(3U, 4U, 1.0);
+        vla::dynarray<std::string, 3U, vla::padded_allocator> b(2U, 3U, 3U, "abc");
+        //--------------------------------------------------------------------------------------------------------------
+        a.resize(5U, 2.0);
+        EXPECT_EQ(a.extent(0U), 5U); EXPECT_EQ(a.size(), 20U); EXPECT_EQ(a.capacity(), 20U);
+        EXPECT_EQ(a(2U, 3U), 1.0); EXPECT_EQ(a(4U, 3U), 2.0);
+        a.resize(6U);
+        EXPECT_EQ(a.capacity(), 30U); EXPECT_EQ(a(5U, 0U), 0.0); EXPECT_EQ(a(0U, 0U), 1.0);
+        const double* p = a.data();
+        a.resize(7U);
+        a.resize(2U);
+        EXPECT_EQ(a.data(), p); EXPECT_EQ(a.size(), 8U);
+        a.shrink_to_fit();
+        EXPECT_EQ(a.capacity(), 8U); EXPECT_EQ(a(1U, 3U), 1.0);
+        b.reserve(4U);
+        b.resize(4U, "x");
+        EXPECT_EQ(b.capacity(), 4U*b.stride(0U));
+        EXPECT_EQ(b(1U, 2U, 1U), "abc"); EXPECT_EQ(b(3U, 2U, 1U), "x");
+        vla::dynarray<double, 2U> e(2U, 3U);
+        e.resize(0U);
+        e.shrink_to_fit();                                      //!<Nothing to relocate.
+        EXPECT_EQ(e.capacity(), 0U); EXPECT_EQ(e.data(), nullptr);
+        //--------------------------------------------------------------------------------------------------------------
+        p = a.data();
+        auto c = std::move(a).reshape(4U, 2U);
+        EXPECT_EQ(c.data(), p); EXPECT_EQ(c(3U, 1U), 1.0);
+        EXPECT_TRUE(a.empty());
+        EXPECT_THROW(std::move(b).reshape(4U, 9U), std::invalid_argument);  //!<Padded (not contiguous).
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    TEST(DynArray_ND, T9){
+        //--------------------------------------------------------------------------------------------------------------
+        constexpr vla::extents<vla::dyn, 3U> e(4U);
+        static_assert(e.stride<0U>() == 3U && e.offset(2U, 1U) == 7U && e.size() == 12U);
+        static_assert(sizeof(vla::extents<vla::dyn, 3U>) == sizeof(size_t));
+        static_assert(vla::extents<2U, vla::dyn, 3U>::rank_dynamic() == 1U);
+        //--------------------------------------------------------------------------------------------------------------
+        vla::mdarray<double, vla::extents<vla::dyn, 3U>> a(4U, 1.0);
+        vla::mdarray<double, vla::extents<vla::dyn, 3U>> b(e);
+        vla::mdarray<int, vla::extents<2U, vla::dyn, 3U>> c(5U, 7);
+        vla::mdarray<int, vla::extents<2U, 2U>> d;
+        //--------------------------------------------------------------------------------------------------------------
+        EXPECT_EQ(a.size(), 12U); EXPECT_EQ(a.extent(0U), 4U); EXPECT_EQ(a.extent<1U>(), 3U);
+        EXPECT_EQ(c.extents(), (std::array<size_t, 3U>{2U, 5U, 3U}));
+        EXPECT_EQ(c.stride(0U), 15U); EXPECT_EQ(c.stride<1U>(), 3U);
+        EXPECT_EQ(&c(1U, 2U, 1U), c.data()+22U);
+        EXPECT_EQ(c[1U][2U][1U], 7);
+        EXPECT_EQ(d.size(), 4U); EXPECT_EQ(d(1U, 1U), 0);
+        EXPECT_THROW(c.at(0U, 5U, 0U), std::out_of_range);
+        for(size_t i = 0U; i < b.extent(0U); ++i){
+            for(size_t j = 0U; j < b.extent<1U>(); ++j){
+                b(i, j) = static_cast<double>(3U*i+j);
+            }
+        }
+        a = 2.0*a+b;
+        EXPECT_EQ(a(3U, 2U), 13.0); EXPECT_EQ(a.at(1U, 0U), 5.0);
+        vla::dynarray_view<const double, 2U> v = a;
+        EXPECT_EQ(v(2U, 1U), a(2U, 1U));
+        auto f = a;
+        EXPECT_EQ(f, a);
+        f(0U, 0U) = -1.0;
+        EXPECT_NE(f, a);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T10){
+        //--------------------------------------------------------------------------------------------------------------
+        using E = vla::extents<vla::dyn, vla::dyn, 3U>;
+        vla::mdarray<int, E> a(5U, 7U);
+        vla::mdarray<int, E, vla::layout_left> b(5U, 7U);
+        vla::mdarray<int, E, vla::layout_tiled<4U>> c(5U, 7U);
+        //--------------------------------------------------------------------------------------------------------------
+        for(size_t i = 0U; i < 5U; ++i){
+            for(size_t j = 0U; j < 7U; ++j){
+                for(size_t k = 0U; k < 3U; ++k){
+                    a(i, j, k) = static_cast<int>(100U*i+10U*j+k);
+                }
+            }
+        }
+        EXPECT_EQ(b.stride(0U), 1U); EXPECT_EQ(b.stride<2U>(), 35U);
+        EXPECT_EQ(&b(1U, 2U, 1U), b.data()+1U+5U*2U+35U);
+        EXPECT_EQ(c.size(), 105U); EXPECT_EQ(c.span(), 8U*8U*4U);  //!<Extents rounded up to multiples of 4.
+        EXPECT_EQ(&c(4U, 1U, 2U), c.data()+64U*2U+16U*0U+4U*1U+2U); //!<Tile (1, 0, 0), offset (0, 1, 2) within it.
+        b = vla::relayout<vla::layout_left>(a);
+        c = vla::relayout<vla::layout_tiled<4U>>(b);
+        EXPECT_EQ(b(4U, 6U, 2U), 462); EXPECT_EQ(c(3U, 5U, 1U), 351);
+        EXPECT_EQ(b.view()(2U, 3U, 1U), 231);
+        EXPECT_EQ(vla::relayout<vla::layout_right>(c), a);
+        size_t n = 0U;
+        int    s = 0;
+        c.for_each([&](int x){++n; s += x;});
+        EXPECT_EQ(n, 105U);
+        EXPECT_EQ(s, 21*(100*2+10*3+1)*5);                      //!<Sum over all i, j and k (padding excluded).
+        std::vector<size_t> o;
+        b.mapping().for_each_index([&](const std::array<size_t, 3U>& i){o.push_back(b.mapping().offset(i));});
+        EXPECT_TRUE(std::is_sorted(o.begin(), o.end()));        //!<Memory order.
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T11){
+        //--------------------------------------------------------------------------------------------------------------
+        static size_t traced = 0U;
+        vla::memory::reset();
+        vla::memory::set_tracer([](const void*, size_t, bool allocation){traced += allocation ? 1U : 0U;});
+        vla::dynarray<double, 2U, vla::counting_allocator> a(4U, 8U, 1.0);
+        vla::dynarray<double, 1U, vla::counting_allocator> b(10U);
+        //--------------------------------------------------------------------------------------------------------------
+        EXPECT_EQ(a.payload_bytes(), 32U*sizeof(double)); EXPECT_GE(a.metadata_bytes(), 2U*2U*sizeof(size_t));
+        EXPECT_EQ(a.allocation_count(), 1U); EXPECT_EQ(b.allocation_count(), 1U);
+        for(size_t i = 0U; i < 100U; ++i){
+            b.resize(b.size()+1U);                              //!<Geometric growth: O(log n) allocations.
+        }
+        EXPECT_LT(b.allocation_count(), 15U);
+        EXPECT_EQ(b.get_allocator().stats().bytes(), b.payload_bytes());
+        auto c = a;                                             //!<Copies start from fresh counters...
+        auto d = std::move(b);                                  //!<...moves carry them along.
+        EXPECT_EQ(c.allocation_count(), 1U); EXPECT_GT(d.allocation_count(), 1U);
+        const auto s = vla::memory::stats();
+        EXPECT_EQ(s.allocations, traced); EXPECT_EQ(s.allocations, 2U+d.allocation_count());
+        EXPECT_EQ(s.bytes(), a.payload_bytes()+c.payload_bytes()+d.payload_bytes());
+        EXPECT_GE(s.peak, s.bytes());
+        vla::memory::set_tracer(nullptr);
+        {
+            vla::dynarray<double, 2U, vla::counting_allocator> e(a);
+        }
+        EXPECT_EQ((vla::memory::stats()-s).allocations, 1U); EXPECT_EQ((vla::memory::stats()-s).bytes(), 0U);
+        EXPECT_EQ(traced, s.allocations);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T12){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::arena r(1U << 12);
+        vla::pool  q;
+        //--------------------------------------------------------------------------------------------------------------
+        {
+            vla::resource_scope scope(r);
+            vla::dynarray<double, 3U, vla::resource_allocator> a(4U, 4U, 4U, 1.0);
+            vla::dynarray<int, 1U, vla::resource_allocator> b(10U);
+            EXPECT_EQ(a.get_allocator().resource(), &r); EXPECT_GE(r.used(), 64U*sizeof(double)+10U*sizeof(int));
+            auto c = a;                                         //!<Copies stay in the arena.
+            const auto f = b;
+            EXPECT_EQ(c.get_allocator().resource(), &r); EXPECT_EQ(f.get_allocator().resource(), &r);
+            const auto g = vla::soa_dynarray<std::tuple<double, int>, 1U, vla::resource_allocator>(4U);
+            const size_t used = r.used();
+            const auto h = g;
+            EXPECT_EQ(h.size(), 4U); EXPECT_GT(r.used(), used);
+            vla::dynarray<double, 2U, vla::resource_allocator> d(64U, 64U); //!<Exceeds the region: new chunk.
+            EXPECT_GE(r.capacity(), 2U*(1U << 12));
+            std::pmr::vector<double> v(a.get_allocator());
+            v.assign(100U, 2.0);
+            EXPECT_EQ(v.get_allocator().resource(), &r);
+            auto e = vla::dynarray<double, 1U, vla::resource_allocator>::map(&q, 8U);
+            EXPECT_EQ(e.get_allocator().resource(), &q);
+            EXPECT_EQ(vla::resource_allocator<double>(std::pmr::polymorphic_allocator<int>(&q)), e.get_allocator());
+        }
+        EXPECT_EQ((vla::dynarray<double, 1U, vla::resource_allocator>(1U).get_allocator().resource()),
+                  std::pmr::get_default_resource());
+        const size_t n = r.capacity();
+        r.release();                                            //!<Chunks merged into a single region.
+        EXPECT_EQ(r.used(), 0U); EXPECT_EQ(r.capacity(), n);
+        //--------------------------------------------------------------------------------------------------------------
+        vla::resource_scope scope(q);
+        const void* p = nullptr;
+        for(size_t i = 0U; i < 3U; ++i){
+            vla::dynarray<double, 1U, vla::resource_allocator> t(100U, 1.0);
+            EXPECT_TRUE(p == nullptr || p == t.data());        //!<Same block at every iteration.
+            p = t.data();
+        }
+        vla::dynarray<double, 1U, vla::resource_allocator> u(1U << 14); //!<Large block (upstream).
+        EXPECT_EQ(u.size(), 1U << 14);
+        //--------------------------------------------------------------------------------------------------------------
+        struct checked : std::pmr::memory_resource{                //!<Checks deallocate against allocate.
+            std::vector<std::tuple<void*, size_t, size_t>> blocks;
+            void* do_allocate(size_t bytes, size_t alignment) override{
+                blocks.emplace_back(std::pmr::new_delete_resource()->allocate(bytes, alignment), bytes, alignment);
+                return std::get<0U>(blocks.back());
+            }
+            void do_deallocate(void* p, size_t bytes, size_t alignment) noexcept override{
+                const auto i = std::find(blocks.begin(), blocks.end(), std::make_tuple(p, bytes, alignment));
+                EXPECT_TRUE(i != blocks.end());
+                if(i != blocks.end()){
+                    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+                    blocks.erase(i);
+                }
+            }
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+                return this == &other;
+            }
+        } upstream;
+        {
+            vla::pool w(&upstream);
+            for(size_t k = 1U; k <= 64U; k *= 2U){                //!<Blocks smaller than the slab header.
+                for(size_t i = 0U; i < 100U; ++i){
+                    std::memset(w.allocate(k, k), 0xFF, k);     //!<Never clobbers a slab header.
+                }
+            }
+            w.release();
+            EXPECT_TRUE(upstream.blocks.empty());
+        }
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T13){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::halo_array<double, 2U> a(vla::halo_width{1U}, 4U, 5U, 1.0), b(vla::halo_width{1U}, 4U, 5U);
+        EXPECT_EQ(a.size(), 20U); EXPECT_EQ(a.extent(1U), 5U); EXPECT_EQ(a.view().size(), 42U);
+        EXPECT_EQ(&a(0, 0), &a.view()(1U, 1U)); EXPECT_EQ(a.data(), &a(0, 0));
+        EXPECT_EQ(a.ghost(0U, 1U).extents(), (std::array<size_t, 2U>{1U, 5U}));
+        EXPECT_EQ(&a.ghost(0U, 1U)(0U, 0U), &a.view()(5U, 1U)); EXPECT_EQ(&a.boundary(1U, 1U)(0U, 0U), &a(0, 4));
+        EXPECT_THROW(a.at(4, 0), std::out_of_range);
+        EXPECT_THROW(a.ghost(2U, 0U), std::out_of_range);
+        //--------------------------------------------------------------------------------------------------------------
+        a.fill(0.0);
+        for(size_t i = 0U; i < 4U; ++i){
+            for(size_t j = 0U; j < 5U; ++j){
+                a(i, j) = static_cast<double>(i*i+j*j);
+            }
+        }
+        const auto laplacian = [](const auto& u){return u(-1, 0)+u(1, 0)+u(0, -1)+u(0, 1)-4.0*u(0, 0);};
+        vla::dynarray<double, 2U> c(4U, 5U);
+        vla::stencil_apply(b, a, laplacian);
+        vla::stencil_apply(c, a, laplacian, {.grain = 1U});
+        EXPECT_EQ(b(1, 1), 4.0); EXPECT_EQ(b(2, 3), 4.0); EXPECT_EQ(b(0, 0), 2.0);  //!<Ghosts are 0.
+        for(size_t i = 0U; i < 4U; ++i){
+            for(size_t j = 0U; j < 5U; ++j){
+                EXPECT_EQ(b(i, j), c(i, j));
+            }
+        }
+        EXPECT_THROW(vla::stencil_apply(vla::dynarray<double, 2U>(4U, 4U), a, laplacian), std::invalid_argument);
+        //--------------------------------------------------------------------------------------------------------------
+        std::vector<double> buffer(a.boundary(0U, 1U).size());
+        EXPECT_EQ(vla::pack(a.boundary(0U, 1U), buffer.data()), 5U);
+        EXPECT_EQ(vla::unpack(buffer.data(), b.ghost(0U, 0U)), 5U);
+        for(size_t j = 0U; j < 5U; ++j){
+            EXPECT_EQ(b.view()(0U, j+1U), a(3, j));
+        }
+        b = 2.0*a;
+        EXPECT_EQ(b(3, 4), 50.0); EXPECT_EQ(b.view()(0U, 1U), 9.0);      //!<Ghosts untouched.
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T14){
+        //--------------------------------------------------------------------------------------------------------------
+        using record = std::tuple<double, int, char>;
+        vla::soa_dynarray<record, 2U> a(3U, 5U);
+        vla::soa_dynarray<record, 2U, vla::counting_allocator> b(3U, 5U);
+        //--------------------------------------------------------------------------------------------------------------
+        EXPECT_EQ(a.size(), 15U); EXPECT_EQ(a.extent(1U), 5U); EXPECT_EQ(b.allocation_count(), 1U);
+        EXPECT_EQ(a.field<0>()(2U, 4U), 0.0); EXPECT_TRUE(a.field<1>().is_contiguous());
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data<1>())%64U, 0U);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data<2>())%64U, 0U);
+        EXPECT_EQ(a.payload_bytes(), 64U*(2U+1U+1U));          //!<120, 60 and 15 bytes, in 64-byte columns.
+        a(1U, 2U) = record{1.5, 2, 'c'};
+        auto [x, i, c] = a(1U, 2U);
+        EXPECT_EQ(x, 1.5); EXPECT_EQ(i, 2); EXPECT_EQ(c, 'c');
+        i = 3;                                                  //!<Proxy (references).
+        EXPECT_EQ(a.field<1>()(1U, 2U), 3); EXPECT_EQ(std::get<0>(a.row(7U)), 1.5);
+        EXPECT_THROW(a.at(3U, 0U), std::out_of_range);
+        //--------------------------------------------------------------------------------------------------------------
+        a.field<0>() = 2.0*a.field<0>()+1.0;                    //!<Field kernel (unit-stride expression).
+        EXPECT_EQ(std::get<0>(a(1U, 2U)), 4.0); EXPECT_EQ(std::get<0>(a(0U, 0U)), 1.0);
+        auto d = a;
+        EXPECT_EQ(d, a); EXPECT_NE(d.data<0>(), a.data<0>());
+        std::get<2>(d(2U, 4U)) = 'z';
+        EXPECT_NE(d, a);
+        const auto e = std::move(d);
+        EXPECT_TRUE(d.empty()); EXPECT_EQ(std::get<2>(e(2U, 4U)), 'z');
+        vla::soa_dynarray<std::tuple<int, int>> f(2U);
+        f.fill({1, 2});
+        std::stringstream ss;
+        ss << f;
+        EXPECT_EQ(ss.str(), "[(1 2) (1 2)]");
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T15){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<double, 3U> a(2U, 3U, 4U);
+        vla::dynarray<double, 2U, vla::padded_allocator> b(3U, 5U, 1.0);
+        //--------------------------------------------------------------------------------------------------------------
+        static_assert(std::contiguous_iterator<decltype(a.begin())>);
+        static_assert(std::forward_iterator<decltype(a.indexed().begin())>);
+        EXPECT_FALSE([]<typename X>(X& x){return requires{x.begin();};}(b)); //!<Padded rows.
+        EXPECT_EQ(a.end()-a.begin(), 24);
+        std::iota(a.begin(), a.end(), 0.0);
+        EXPECT_EQ(a(1U, 2U, 3U), 23.0);
+        std::transform(a.begin(), a.end(), a.begin(), [](double x){return 2.0*x;});
+        EXPECT_EQ(std::reduce(std::as_const(a).begin(), std::as_const(a).end()), 552.0);
+        //--------------------------------------------------------------------------------------------------------------
+        size_t n = 0U;
+        for(auto [i, j, k, x] : a.indexed()){
+            EXPECT_EQ(x, 2.0*static_cast<double>((i*3U+j)*4U+k));
+            x = 0.0;
+            ++n;
+        }
+        EXPECT_EQ(n, 24U); EXPECT_EQ(std::count(a.begin(), a.end(), 0.0), 24);
+        for(auto [i, j, x] : b.indexed()){                      //!<Skips the padding.
+            x = static_cast<double>(i+j);
+        }
+        EXPECT_EQ(b(2U, 4U), 6.0); EXPECT_EQ(b.data()[b.leading_dimension()-1U], 1.0);
+        double sum = 0.0;
+        for(auto [j, i, x] : b.view().transpose().indexed()){
+            sum += x*static_cast<double>(i == 0U);
+        }
+        EXPECT_EQ(sum, 10.0);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T16){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<double, 2U> a(37U, 53U);
+        vla::dynarray<double, 2U> b(37U, 53U, 0.5);
+        vla::dynarray<float> c(1U << 20U, 0.1F);
+        vla::dynarray<int> d({3, -7, 5, -7, 9, 9, 1});
+        vla::dynarray<double, 2U, vla::padded_allocator> e(5U, 7U, -2.0);
+        vla::dynarray<double> f(1000U, 1.0);
+        f[0U] = std::numeric_limits<double>::quiet_NaN();
+        //--------------------------------------------------------------------------------------------------------------
+        for(auto [i, j, x] : a.indexed()){
+            x = std::sin(static_cast<double>(i*53U+j));
+        }
+        const auto t = a.view().transpose();                    //!<Strided rows (scalar path).
+        const auto s = a.slice(1U, 2U, 20U, 2U);
+        const auto previous = vla::numeric::current_isa();
+        for(auto i : {vla::numeric::isa::baseline, vla::numeric::isa::avx2, vla::numeric::isa::avx512}){
+            vla::numeric::set_isa(i);
+            EXPECT_LE(vla::numeric::current_isa(), vla::numeric::supported_isa());
+            vla::numeric::set_isa(vla::numeric::isa::baseline);
+            const double sum = vla::numeric::sum(a);
+            const size_t   k = vla::numeric::argmax(a);
+            vla::numeric::set_isa(i);
+            EXPECT_EQ(vla::numeric::sum(a), sum);               //!<Bitwise identical across instruction sets.
+            EXPECT_EQ(vla::numeric::argmax(a), k);
+            EXPECT_EQ(vla::numeric::max(a), a.data()[k]);
+            EXPECT_EQ(vla::numeric::min(t), vla::numeric::min(a));
+            EXPECT_EQ(t.data()[0U], a(0U, 0U));
+            EXPECT_NEAR(vla::numeric::sum(t), sum, 1e-12);
+            EXPECT_NEAR(vla::numeric::pairwise_sum(a), sum, 1e-12);
+            EXPECT_NEAR(vla::numeric::dot(a, b), 0.5*sum, 1e-12);
+            EXPECT_NEAR(vla::numeric::dot(t, b.view().transpose()), 0.5*sum, 1e-12);
+            EXPECT_NEAR(vla::numeric::norm2(a), std::sqrt(vla::numeric::dot(t, t)), 1e-12);
+            EXPECT_EQ(vla::numeric::argmin(d), 1U);             //!<First of the ties.
+            EXPECT_EQ(vla::numeric::argmax(d), 4U);
+            EXPECT_LT(vla::numeric::argmin(f), f.size());      //!<NaNs: unspecified, but in bounds.
+            EXPECT_LT(vla::numeric::argmax(f), f.size());
+            EXPECT_EQ(vla::numeric::norm1(d), 41);
+            EXPECT_EQ(vla::numeric::norm_inf(d), 9);
+            EXPECT_EQ(vla::numeric::norm1(e), 70.0);
+            EXPECT_EQ(vla::numeric::sum(s), vla::numeric::sum(a.slice(1U, 2U, 20U, 2U)));
+            EXPECT_NEAR(vla::numeric::kahan_sum(c), 104857.6F, 1e-2F);
+            EXPECT_GT(std::abs(vla::numeric::sum(c)-104857.6F), 1e-2F);
+        }
+        vla::numeric::set_isa(previous);
+        EXPECT_LT(std::abs(vla::numeric::pairwise_sum(c)-104857.6F), std::abs(vla::numeric::sum(c)-104857.6F));
+        //--------------------------------------------------------------------------------------------------------------
+        vla::numeric::axpy(2.0, b, a);
+        vla::numeric::axpy(-2.0, b.view().transpose(), a.view().transpose());
+        EXPECT_DOUBLE_EQ(a(36U, 52U), std::sin(36.0*53.0+52.0));
+        EXPECT_THROW(vla::numeric::dot(a, t), std::invalid_argument);
+        EXPECT_THROW(vla::numeric::min(vla::dynarray<double>()), std::invalid_argument);
+        EXPECT_EQ(vla::numeric::sum(vla::dynarray<double>()), 0.0);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_ND, T17){
+        //--------------------------------------------------------------------------------------------------------------
+        const auto path = std::filesystem::temp_directory_path()/"DynArrayTest_T17.dcz";
+        vla::parallel::thread_pool p(3U);
+        vla::dynarray<double, 3U> a(20U, 30U, 40U);
+        vla::dynarray<std::uint8_t> b(100000U);
+        //--------------------------------------------------------------------------------------------------------------
+        for(auto [i, j, k, x] : a.indexed()){
+            x = 1.0+0.001*static_cast<double>(i)+static_cast<double>(j%4U);  //!<Smooth (compressible) field.
+        }
+        std::uint64_t state = 88172645463325252U;
+        for(size_t i = 0U; i < b.size(); ++i){
+            state ^= state << 13U; state ^= state >> 7U; state ^= state << 17U;
+            b[i] = static_cast<std::uint8_t>(state >> 56U);    //!<Incompressible (xorshift).
+        }
+        vla::save_compressed(path, a, 4096U, {.pool = &p});
+        {
+            vla::compressed_reader<double, 3U> r(path);
+            EXPECT_EQ(r.extents(), a.extents());
+            EXPECT_EQ(r.block_size(), 512U); EXPECT_EQ(r.blocks(), 47U);
+            EXPECT_LT(4U*r.compressed_bytes(), a.size()*sizeof(double));
+            vla::dynarray<double, 3U> c(20U, 30U, 40U);
+            r.read(c, {.pool = &p});
+            EXPECT_TRUE(std::equal(a.begin(), a.end(), c.begin()));
+            vla::dynarray<double, 3U> d(3U, 5U, 7U);
+            r.read({17U, 2U, 33U}, d);                          //!<Sub-box (decodes 15 rows' blocks only).
+            EXPECT_EQ(d(2U, 4U, 6U), a(19U, 6U, 39U)); EXPECT_EQ(d(0U, 0U, 0U), a(17U, 2U, 33U));
+            vla::dynarray<double, 3U> e(30U, 20U, 40U);
+            r.read({0U, 0U, 0U}, e.view().transpose(0U, 1U));  //!<Strided destination.
+            EXPECT_EQ(e(29U, 19U, 39U), a(19U, 29U, 39U));
+            EXPECT_THROW(r.read({18U, 0U, 0U}, d), std::out_of_range);
+            EXPECT_THROW(r.read(d), std::invalid_argument);
+        }
+        EXPECT_THROW((vla::compressed_reader<double, 3U, vla::raw_codec>(path)), std::invalid_argument);
+        EXPECT_THROW((vla::compressed_reader<float, 3U>(path)), std::invalid_argument);
+        vla::save_compressed(path, a.view().transpose());      //!<Non-contiguous source.
+        EXPECT_EQ((vla::load_compressed<double, 3U>(path)(39U, 29U, 19U)), a(19U, 29U, 39U));
+        //--------------------------------------------------------------------------------------------------------------
+        vla::save_compressed(path, b);
+        auto f = vla::load_compressed<std::uint8_t>(path);
+        EXPECT_EQ(f, b);
+        EXPECT_EQ(vla::compressed_reader<std::uint8_t>(path).compressed_bytes(), b.size()); //!<Stored raw.
+        vla::save_compressed<vla::raw_codec>(path, vla::dynarray<int>());
+        EXPECT_TRUE((vla::load_compressed<int, 1U, vla::raw_codec>(path).empty()));
+        //--------------------------------------------------------------------------------------------------------------
+        std::vector<std::byte> g(5000U), h(vla::shuffle_lz_codec::bound(g.size())), i(g.size());
+        for(size_t j = 0U; j < g.size(); ++j){
+            g[j] = static_cast<std::byte>(j%3U == 0U ? j%251U : 7U); //!<Short and overlapping matches.
+        }
+        const size_t m = vla::shuffle_lz_codec::compress(g.data(), g.size(), 4U, h.data());
+        vla::shuffle_lz_codec::decompress(h.data(), m, 4U, i.data(), i.size());
+        EXPECT_LT(m, g.size()); EXPECT_TRUE(g == i);
+        EXPECT_THROW(vla::shuffle_lz_codec::decompress(h.data(), m-1U, 4U, i.data(), i.size()), std::invalid_argument);
+        std::filesystem::remove(path);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    struct throwing{                                            //!<Throws on its budget-th construction.
+        static inline int budget = 0, live = 0;
+        throwing(){
+            construct();
+        }
+        throwing(const throwing&){
+            construct();
+        }
+        ~throwing(){
+            --live;
+        }
+        static void construct(){
+            if(--budget == 0){
+                throw std::runtime_error("throwing::construct()");
+            }
+            ++live;
+        }
+    };
+    TEST(DynArray_ND, T18){
+        //--------------------------------------------------------------------------------------------------------------
+        throwing::budget = 5;
+        EXPECT_THROW((vla::dynarray<throwing, 2U>(3U, 3U)), std::runtime_error);
+        EXPECT_EQ(throwing::live, 0);
+        throwing::budget = 100;
+        const vla::dynarray<throwing, 2U> a(3U, 3U);
+        throwing::budget = 5;
+        EXPECT_THROW((vla::dynarray<throwing, 2U>(a)), std::runtime_error);
+        EXPECT_EQ(throwing::live, 9);
+        //--------------------------------------------------------------------------------------------------------------
+        throwing::budget = 5;
+        EXPECT_THROW((vla::dynarray<throwing, 1U>(9U)), std::runtime_error);
+        EXPECT_EQ(throwing::live, 9);
+        throwing::budget = 100;
+        const vla::dynarray<throwing, 1U> b(9U);
+        throwing::budget = 5;
+        EXPECT_THROW((vla::dynarray<throwing, 1U>(b)), std::runtime_error);
+        EXPECT_EQ(throwing::live, 18);
+        //--------------------------------------------------------------------------------------------------------------
+        throwing::budget = 3;
+        EXPECT_THROW((vla::dynarray<throwing, 2U>(vla::default_init, 2U, 2U)), std::runtime_error);
+        throwing::budget = 3;
+        EXPECT_THROW((vla::dynarray<throwing, 1U>(vla::default_init, 4U)), std::runtime_error);
+        EXPECT_EQ(throwing::live, 18);
+        throwing::budget = 3;
+        EXPECT_THROW((vla::small_dynarray<throwing, 4U>(vla::default_init, 4U)), std::runtime_error);  //!<Inline.
+        throwing::budget = 3;
+        EXPECT_THROW((vla::small_dynarray<throwing, 4U>(vla::default_init, 8U)), std::runtime_error);  //!<Heap.
+        EXPECT_EQ(throwing::live, 18);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    class DynArray_View : public ::testing::Test{
+    };
+    TEST(DynArray_View, T1){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<int, 3U> a(4U, 5U, 6U);
+        for(size_t i = 0U; i < a.size(); ++i){
+            a.data()[i] = static_cast<int>(i);
+        }
+        auto b = a.slice(2U, 5U);                               //!<4x5 face k = 5.
+        auto c = a.slice(0U, 1U, 2U, 2U);                       //!<Rows i = 1, 3.
+        auto d = a.subarray({1U, 1U, 1U}, {2U, 3U, 4U});        //!<Interior block.
+        auto e = a.transpose();                                 //!<6x5x4.
+        auto f = a.reshape(20U, 6U);
+        vla::dynarray_view<const int, 3U> g = a;
+        //--------------------------------------------------------------------------------------------------------------
+        static_assert(std::is_trivially_copyable_v<vla::dynarray_view<int, 3U>>);
+        EXPECT_EQ(b.extent(0U), 4U); EXPECT_EQ(b.extent(1U), 5U);
+        EXPECT_EQ(b(2U, 3U), a(2U, 3U, 5U));
+        EXPECT_EQ(c.extent(0U), 2U);
+        EXPECT_EQ(c(1U, 4U, 2U), a(3U, 4U, 2U));
+        EXPECT_EQ(d(0U, 0U, 0U), a(1U, 1U, 1U));
+        EXPECT_EQ(d(1U, 2U, 3U), a(2U, 3U, 4U));
+        EXPECT_EQ(e(5U, 4U, 3U), a(3U, 4U, 5U));
+        EXPECT_EQ(e.transpose(0U, 2U)(3U, 4U, 5U), a(3U, 4U, 5U));
+        EXPECT_EQ(f(7U, 1U), 43);
+        EXPECT_EQ(g[3U][4U][5U], a(3U, 4U, 5U));
+        EXPECT_TRUE(a.view().is_contiguous());
+        EXPECT_FALSE(d.is_contiguous());
+        EXPECT_THROW(d.reshape(24U), std::invalid_argument);
+        EXPECT_THROW(a.subarray({3U, 0U, 0U}, {2U, 1U, 1U}), std::out_of_range);
+        d(0U, 0U, 0U) = -1;
+        EXPECT_EQ(a(1U, 1U, 1U), -1);                           //!<Views alias the array storage.
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    class DynArray_Expression : public ::testing::Test{
+    };
+    TEST(DynArray_Expression, T1){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::dynarray<double, 2U> a(3U, 4U);
+        vla::dynarray<double, 2U> b(3U, 4U, 1.0);
+        vla::dynarray<double, 2U> c(3U, 4U, 2.0);
+        vla::dynarray<double, 2U> d(4U, 3U);
+        vla::dynarray<double, 2U, vla::padded_allocator> e(3U, 4U, 4.0);
+        vla::dynarray<float> f(3U, 1.0F);
+        //--------------------------------------------------------------------------------------------------------------
+        a = b+0.5*c;                                            //!<Contiguous (flat) evaluation.
+        EXPECT_EQ(a(2U, 3U), 2.0);
+        a += vla::sqrt(e)-b;                                    //!<Strided (row) evaluation.
+        EXPECT_EQ(a(1U, 1U), 3.0);
+        a.slice(0U, 1U) = -b.slice(0U, 0U);
+        EXPECT_EQ(a(1U, 2U), -1.0); EXPECT_EQ(a(0U, 2U), 3.0);
+        d = a.transpose()*2.0;
+        EXPECT_EQ(d(2U, 1U), -2.0);
+        e = vla::max(a, 0.0);
+        EXPECT_EQ(e(1U, 0U), 0.0); EXPECT_EQ(e(2U, 0U), 3.0);
+        a *= 2.0;
+        EXPECT_EQ(a(2U, 3U), 6.0);
+        f = vla::pow(f+1.0F, 2.0F)/4.0F;
+        EXPECT_EQ(f[2U], 1.0F);
+        EXPECT_THROW(a = b+d, std::invalid_argument);          //!<3x4 vs. 4x3.
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    class DynArray_Parallel : public ::testing::Test{
+    };
+    TEST(DynArray_Parallel, T1){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::parallel::thread_pool p(4U);
+        vla::dynarray<double, 2U> a(300U, 200U);
+        vla::dynarray<double, 2U> b(300U, 200U);
+        vla::dynarray<double, 2U, vla::padded_allocator> c(300U, 201U);
+        std::vector<double> s;
+        //--------------------------------------------------------------------------------------------------------------
+        vla::parallel::fill(a, 1.0, {.grain = 7U, .pool = &p});
+        vla::parallel::for_each(a.slice(0U, 10U), [](double& x){x = 3.0;}, {.pool = &p});
+        EXPECT_EQ(a(10U, 199U), 3.0); EXPECT_EQ(a(11U, 0U), 1.0);
+        vla::parallel::transform(a, b, [](double x){return 2.0*x;}, {.grain = 3U, .pool = &p});
+        EXPECT_EQ(b(10U, 5U), 6.0); EXPECT_EQ(b(299U, 199U), 2.0);
+        vla::parallel::transform(a, b.transpose().transpose(), c.subarray({0U, 1U}, {300U, 200U}), std::plus<>{},
+                                 {.grain = 5U, .pool = &p});          //!<Strided (row) traversal.
+        EXPECT_EQ(c(10U, 200U), 9.0); EXPECT_EQ(c(0U, 0U), 0.0);
+        EXPECT_EQ(vla::parallel::reduce(a, 0.0, std::plus<>{}, {.pool = &p}), 60400.0);
+        EXPECT_EQ(vla::parallel::transform_reduce(a, b, 0.0, std::plus<>{}, std::multiplies<>{}, {.pool = &p}),
+                  123200.0);
+        EXPECT_EQ(vla::parallel::transform_reduce(b, -9.0, [](double x, double y){return std::max(x, y);},
+                                                  [](double x){return -x;}, {.pool = &p}), -2.0);
+        //--------------------------------------------------------------------------------------------------------------
+        for(size_t n : {1U, 2U, 4U}){                           //!<Deterministic: independent of the number of threads.
+            vla::parallel::thread_pool q(n);
+            vla::parallel::for_each(a, [](double& x){x = 1.0/(1.0+x);}, {.pool = &q});
+            s.push_back(vla::parallel::reduce(a.view(), 0.0, std::plus<>{}, {.grain = 9U, .deterministic = true,
+                                                                               .pool = &q}));
+            vla::parallel::for_each(a, [](double& x){x = 1.0/x-1.0;}, {.pool = &q});
+        }
+        EXPECT_EQ(s[0U], s[1U]); EXPECT_EQ(s[0U], s[2U]);
+        EXPECT_THROW(vla::parallel::for_range(100U, [](size_t first, size_t){
+            if(first == 42U) throw std::runtime_error("");
+        }, {.grain = 1U, .pool = &p}), std::runtime_error);
+        EXPECT_THROW(vla::parallel::transform(a, b.transpose(), [](double x){return x;}), std::invalid_argument);
+        vla::parallel::thread_pool r(0U);                       //!<No workers: tasks run inline.
+        int t = 0;
+        r.submit([&t](){++t;});
+        r.submit([&t](){++t;}, 3U);
+        EXPECT_EQ(t, 2); EXPECT_FALSE(r.run_one());
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    //------------------------------------------------------------------------------------------------------------------
+    TEST(DynArray_Parallel, T2){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::parallel::thread_pool p(4U, true);
+        vla::parallel::policy q{.grain = 8U, .pinned = true, .pool = &p};
+        vla::dynarray<double, 2U> a(vla::parallel::first_touch_t{q}, 300U, 2000U, 2.0);
+        vla::dynarray<std::string, 2U, vla::padded_allocator> b(vla::parallel::first_touch, 30U, 3U, "abc");
+        vla::dynarray<int> c(vla::parallel::first_touch_t{q}, 1000U);
+        //--------------------------------------------------------------------------------------------------------------
+        EXPECT_EQ(a(0U, 0U), 2.0); EXPECT_EQ(a(299U, 1999U), 2.0);
+        EXPECT_EQ(b(29U, 2U), "abc");
+        EXPECT_EQ(c[999U], 0);
+        EXPECT_EQ(vla::parallel::reduce(a, 0.0, std::plus<>{}, q), 1200000.0);
+        //--------------------------------------------------------------------------------------------------------------
+        const auto r = vla::numa::pages(a);                     //!<All absent if move_pages is not permitted.
+        const auto s = vla::numa::page_size();
+        const auto n = (std::bit_cast<std::uintptr_t>(&a(299U, 1999U))/s-std::bit_cast<std::uintptr_t>(a.data())/s)+1U;
+        EXPECT_EQ(r.size(), n);
+        EXPECT_GE(r.pages.size(), vla::numa::nodes());
+        EXPECT_EQ(vla::numa::pages(vla::dynarray<double>()).size(), 0U);
+        //--------------------------------------------------------------------------------------------------------------
+    }
+    TEST(DynArray_Parallel, T3){
+        //--------------------------------------------------------------------------------------------------------------
+        vla::parallel::thread_pool p(4U);
+        vla::parallel::policy q{.grain = 16U, .pool = &p};
+        vla::dynarray<double, 2U> a(10U, 10U);
+        vla::dynarray<double, 2U> b(10U, 10U);
+        vla::dynarray<int> c(10U, 100);
+        vla::dynarray<int> d(10U, -1);
+        //--------------------------------------------------------------------------------------------------------------
+        const auto u = vla::parallel::make_atomic_view(a);
+        const auto v = vla::parallel::make_atomic_view(c);
+        vla::parallel::privatized<double, 2U> w(b, 0.0, q);
+        vla::parallel::privatized<int> x(d, -1, q);
+        vla::parallel::for_range(10000U, [&](size_t first, size_t last){ //!<Elements e scatter into 4 entries each.
+            auto& s = w.local();
+            auto& t = x.local();
+            for(size_t e = first; e < last; ++e){
+                for(size_t k = 0U; k < 4U; ++k){
+                    const size_t i = (e+k)%10U, j = (e*7U+k)%10U;
+                    u(i, j) += 0.25;
+                    s(i, j) += 0.25;
+                    v(i).min(static_cast<int>(e%97U));
+                    t[j] = std::max(t[j], static_cast<int>(e%89U));
+                }
+            }
+        }, q);
+        EXPECT_EQ(vla::numeric::sum(a), 10000.0);               //!<Exact (multiples of 0.25).
+        EXPECT_GE(w.copies(), 1U); EXPECT_LE(w.copies(), p.size()+1U);
+        w.merge();
+        x.merge(vla::parallel::max_op{});
+        EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin()));
+        EXPECT_EQ(c, vla::dynarray<int>(10U, 0));
+        EXPECT_EQ(d, vla::dynarray<int>(10U, 88));
+        w.merge();                                              //!<Copies were reset (to init).
+        EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin()));
+        EXPECT_EQ(p.worker(), p.size());
+        u.at(9U, 9U).store(-1.0);
+        EXPECT_EQ(u(9U, 9U).load(), -1.0);
+        EXPECT_THROW(u.at(10U, 0U), std::out_of_range);
+        //--------------------------------------------------------------------------------------------------------------
     }
     //------------------------------------------------------------------------------------------------------------------
 }